@@ -17,6 +17,8 @@
 #include "amplitudes/pomeron_exchange.hpp"
 #include "amplitudes/amplitude_sum.hpp"
 #include "box/box_amplitude.hpp"
+#include "tools/checkpoint.hpp"
+#include "tools/scan_writer.hpp"
 
 #include "jpacGraph1D.hpp"
 
@@ -156,15 +158,26 @@ int main( int argc, char** argv )
     for (int n = 0; n < amps.size(); n++)
     {
         std::cout << "\nPrinting amplitude: " << amps[n]->_identifier << "\n";
-        auto F = [&](double egam)
+
+        // Finished points and all discontinuities are saved as they are calculated
+        // so running again after an interruption continues where it stopped
+        checkpoint cp(amps[n]->_identifier + ".ckpt");
+        amps[n]->set_checkpoint(&cp);
+
+        // One point at a time since each box is already evaluated in parallel
+        scan_writer out(amps[n]->_identifier + ".dat", {"egam", "sigma"}, SCAN_FORMAT::CSV, 1);
+        stream_scan(out, N, 1, [&](long i, int thread)
         {
+            double egam = xmin + double(i) * (xmax - xmin) / double(N - 1);
             double s = pow(W_cm(egam), 2.);
-            return amps[n]->integrated_xsection(s);
-        };
-        
-        auto x_fx = vec_fill(N, F, xmin, xmax, true);
-        vec_print(x_fx[0], x_fx[1], amps[n]->_identifier + ".dat");
-        plotter->AddEntry(std::get<0>(x_fx), std::get<1>(x_fx), amps[n]->_identifier);
+            double sigma = amps[n]->integrated_xsection(s);
+
+            std::cout << std::left << std::setw(15) << egam << std::setw(15) << sigma << "\n";
+            return std::vector<double>{egam, sigma};
+        });
+
+        scan_data x_fx = read_scan(amps[n]->_identifier + ".dat");
+        plotter->AddEntry(x_fx.columns[0], x_fx.columns[1], amps[n]->_identifier);
     }
 
     plotter->SetLegend(0.2, 0.3);
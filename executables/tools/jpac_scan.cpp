@@ -0,0 +1,51 @@
+// ---------------------------------------------------------------------------
+// Evaluate the scans described in a configuration file (see tools/scan_config.hpp)
+// and write them to data files, using all available threads by default.
+//
+// Usage: jpac_scan <config> [-j <threads>] [-s <index>/<N>] [-m <N>]
+//
+//  -j  number of threads
+//  -s  only compute shard index (from 0) of N of every scan, e.g. as one of N batch jobs
+//  -m  assemble the scans after all N shards were computed
+//
+// Interrupted scans are continued when run again with the same options.
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/scan_config.hpp"
+
+#include <cstring>
+#include <iostream>
+
+using namespace jpacPhoto;
+
+int main( int argc, char** argv )
+{
+    std::string filename = "";
+    int nThreads = get_threads();
+    scan_shard shard;
+    int nMerge = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i],"-j")==0 && i + 1 < argc) nThreads = atoi(argv[++i]);
+        else if (std::strcmp(argv[i],"-s")==0 && i + 1 < argc) shard = parse_shard(argv[++i]);
+        else if (std::strcmp(argv[i],"-m")==0 && i + 1 < argc) nMerge = atoi(argv[++i]);
+        else filename = argv[i];
+    }
+
+    if (filename == "")
+    {
+        std::cout << "Usage: jpac_scan <config> [-j <threads>] [-s <index>/<N>] [-m <N>]\n";
+        return 1;
+    }
+
+    scan_config config(filename);
+    if (!config.is_valid()) return 1;
+
+    bool success = (nMerge > 0) ? config.merge(nMerge) : config.run(nThreads, shard);
+    return success ? 0 : 1;
+};
@@ -0,0 +1,47 @@
+// ---------------------------------------------------------------------------
+// Assemble a scan which was split between several processes with sharded_scan()
+// into a single file, after checking all shards are complete and consistent.
+//
+// Usage: merge_scan -f sigma.scan -n <number of points> -s <number of shards> [-c <chunk>]
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/scan_writer.hpp"
+
+#include <cstring>
+#include <iostream>
+
+using namespace jpacPhoto;
+
+int main( int argc, char** argv )
+{
+    std::string filename = "";
+    long N = 0;
+    int nShards = 0, chunk = 256;
+
+    for (int i = 0; i < argc - 1; i++)
+    {
+        if (std::strcmp(argv[i],"-f")==0) filename = argv[i+1];
+        if (std::strcmp(argv[i],"-n")==0) N = atol(argv[i+1]);
+        if (std::strcmp(argv[i],"-s")==0) nShards = atoi(argv[i+1]);
+        if (std::strcmp(argv[i],"-c")==0) chunk = atoi(argv[i+1]);
+    }
+
+    if (filename == "" || N < 1 || nShards < 1)
+    {
+        std::cout << "Usage: merge_scan -f <file> -n <number of points> -s <number of shards> [-c <chunk>]\n";
+        return 1;
+    }
+
+    if (!merge_shards(filename, N, nShards, chunk))
+    {
+        std::cout << "merge_scan: " << filename << " was not written.\n";
+        return 1;
+    }
+
+    std::cout << "merge_scan: " << N << " points from " << nShards << " shards written to " << filename << ".\n";
+    return 0;
+};
@@ -20,6 +20,7 @@
 // ---------------------------------------------------------------------------
 
 #include "reaction_kinematics.hpp"
+#include "dual.hpp"
 
 #include "Math/GSLIntegrator.h"
 #include "Math/IntegrationTypes.h"
@@ -27,6 +28,7 @@
 
 #include <string>
 #include <algorithm>
+#include <functional>
 
 namespace jpacPhoto
 {
@@ -38,6 +40,16 @@ namespace jpacPhoto
         : _kinematics(xkinem), _identifier(id)
         {};
 
+        virtual ~amplitude(){};
+
+        // Amplitudes save the last point evaluated and so a single instance cannot be shared between threads.
+        // Parallel tools (see tools/parallel.hpp) instead evaluate independent copies made by clone().
+        // The default returns NULL, in which case the amplitude is only evaluated serially.
+        virtual amplitude * clone()
+        {
+            return NULL;
+        };
+
         // Kinematics object for thresholds and etc.
         reaction_kinematics * _kinematics;
 
@@ -59,8 +71,121 @@ namespace jpacPhoto
         inline void set_debug(int d)
         {
             _debug = d;
+            _helicity_mask.clear(); // debug may change which amplitudes are available and their phases
+        };
+
+        // ---------------------------------------------------------------------------
+        // Poles in the s-channel as {mass, width} pairs, around which observables vary rapidly in energy.
+        // Used for example to seed the sampling of energy scans (see tools/adaptive_sampler.hpp)
+        virtual std::vector<std::array<double, 2>> resonances()
+        {
+            return {};
+        };
+
+        // ---------------------------------------------------------------------------
+        // Many helicity amplitudes vanish identically by construction.
+        // Derived classes can declare these by overriding is_nonzero() and they will be
+        // skipped entirely in check_cache() and the observables.
+        virtual bool is_nonzero(std::array<int, 4> helicities)
+        {
+            // Real photons have no longitudinal polarization
+            return !(helicities[0] == 0 && _kinematics->_photon);
+        };
+
+        // Mask over the helicity table of _kinematics, true for amplitudes which need to be calculated
+        std::vector<bool> _helicity_mask;
+        inline void update_mask()
+        {
+            _helicity_mask.clear();
+            for (int i = 0; i < _kinematics->_nAmps; i++)
+            {
+                _helicity_mask.push_back(is_nonzero(_kinematics->_helicities[i]));
+            }
         };
 
+        // ---------------------------------------------------------------------------
+        // Spin-summed evaluation
+        // Covariant amplitudes may be able to calculate sum_λ |A|^2 directly through 
+        // Dirac traces and polarization sums instead of evaluating every helicity amplitude.
+        // If available and turned on, probability_distribution() will use this instead.
+        bool _useTraces = false;
+        inline void set_traces(bool TRACES = true)
+        {
+            _useTraces = TRACES;
+        };
+
+        // Whether the current settings of the amplitude allow the trace evaluation
+        virtual bool traces_available()
+        {
+            return false;
+        };
+
+        // Unpolarized sum over all helicities of |A|^2 at fixed s and t
+        virtual double spin_summed_squared(double s, double t)
+        {
+            return 0.;
+        };
+
+        // ---------------------------------------------------------------------------
+        // Derivatives with respect to parameters
+        // Amplitudes which can be evaluated with dual numbers (see dual.hpp) give the exact
+        // derivatives with respect to every parameter passed to set_params() in a single evaluation.
+        virtual bool gradient_available()
+        {
+            return false;
+        };
+
+        // Helicity amplitude together with its derivatives with respect to each parameter
+        virtual dual helicity_gradient(std::array<int, 4> helicities, double s, double t)
+        {
+            return helicity_amplitude(helicities, s, t);
+        };
+
+        // ---------------------------------------------------------------------------
+        // Factorization into coupling monomials
+        // Many amplitudes can be written as
+        //
+        //   A_h(p; s, t) = sum_m c_m(p; s, t) B_{h,m}(s, t)
+        //
+        // with coefficients c_m which are cheap to evaluate, independent of helicity and carry all
+        // dependence on the parameters p, and structures B which do not depend on the parameters.
+        // Many parameter sets can then be evaluated from a single calculation of B 
+        // (see tools/batch_evaluator.hpp). n_monomials() = 0 means no factorization is available.
+        virtual int n_monomials()
+        {
+            return 0;
+        };
+
+        // Coefficients c_m for a given parameter vector (in the same order as set_params())
+        virtual std::vector<std::complex<double>> coupling_monomials(std::vector<double> params, double s, double t)
+        {
+            return {};
+        };
+
+        // Structures B_{h,m} for a given helicity combination
+        virtual std::vector<std::complex<double>> monomial_amplitudes(std::array<int, 4> helicities, double s, double t)
+        {
+            return {};
+        };
+
+        // Parameter independent inputs of the coefficients at fixed (s, t), e.g. kinematic factors,
+        // which can be saved once and passed to saved_coupling_monomials() for every new parameter set
+        virtual std::vector<std::complex<double>> monomial_kinematics(double s, double t)
+        {
+            return {s, t};
+        };
+
+        // Same as coupling_monomials() from the output of monomial_kinematics()
+        virtual std::vector<std::complex<double>> saved_coupling_monomials(std::vector<double> params, std::vector<std::complex<double>> kinematics)
+        {
+            return coupling_monomials(params, std::real(kinematics[0]), std::real(kinematics[1]));
+        };
+
+        // Same as check_cache() for the dual amplitudes
+        double _cached_dual_mX2 = 0., _cached_dual_s = 0., _cached_dual_t = 0.;
+        std::vector<dual> _cached_dual_amplitude;
+        void check_dual_cache(double s, double t);
+
         // ---------------------------------------------------------------------------
         // Observables
         // Evaluatable in terms of s and t or an event object (see reaction_kinematics.hpp)
@@ -69,10 +194,16 @@ namespace jpacPhoto
         double probability_distribution(double s, double t);
 
         // Differential and total cross-section
-        double differential_xsection(double s, double t);
+        // (virtual because some amplitudes, e.g. primakoff_effect, are only defined at the cross-section level)
+        virtual double differential_xsection(double s, double t);
 
         // integrated crossection
-        double integrated_xsection(double s);
+        virtual double integrated_xsection(double s);
+
+        // Same as above but also filling gradient with the derivatives with respect to each parameter
+        // Requires gradient_available()
+        double probability_gradient(double s, double t, std::vector<double> & gradient);
+        double differential_xsection_gradient(double s, double t, std::vector<double> & gradient);
 
         // Spin asymmetries
         double A_LL(double s, double t); // Beam and target
@@ -96,12 +227,48 @@ namespace jpacPhoto
 
         void check_cache(double s, double t);
 
+        // Store helicity amplitudes at s, t calculated elsewhere (e.g. recombined from monomial_amplitudes())
+        // Either all of them or only the first half if the parity relation is used, in which case the rest are filled in
+        void set_cache(double s, double t, std::vector<std::complex<double>> amplitudes);
+
+        // Phase relating amplitudes with all helicities flipped
+        // returning 0 means no relation is known and all helicity amplitudes will be calculated
         virtual int parity_phase(std::array<int,4> helicities)
         {
             return 0;
         };
 
+        // Phases for the first half of the helicity table and whether they can all be used
+        bool _useParity = false;
+        std::vector<int> _parity_phases;
+        inline void update_parity()
+        {
+            _parity_phases.clear();
+            _useParity = true;
+            for (int i = 0; i < _kinematics->_nAmps / 2; i++)
+            {
+                int eta = parity_phase(_kinematics->_helicities[i]);
+                if (eta == 0) _useParity = false;
+
+                _parity_phases.push_back(eta);
+            }
+        };
+
         // ---------------------------------------------------------------------------
+        // Free parameters (couplings, normalizations, etc.) are all passed in a single vector
+        // so that any amplitude can be varied in the same way, e.g. by tools/fitter.hpp
+        virtual void set_params(std::vector<double> params)
+        {
+            check_nParams(params);
+        };
+
+        // Changing parameters invalidates the cached helicity amplitudes even at the same s and t
+        virtual void reset_cache()
+        {
+            _cached_helicity_amplitude.clear();
+            _cached_dual_amplitude.clear();
+        };
+
         // nParams error message
         int _nParams = 0;
         inline void set_nParams(int N){ _nParams = N; };
@@ -134,6 +301,14 @@ namespace jpacPhoto
             }      
         };
     };
+
+    // Any observable as a function of s and t, e.g. &amplitude::differential_xsection 
+    // or a lambda for observables with additional arguments such as SDMEs
+    typedef std::function<double(amplitude*, double, double)> observable;
+
+    // Observable which also fills its derivatives with respect to the amplitude parameters
+    // e.g. &amplitude::differential_xsection_gradient
+    typedef std::function<double(amplitude*, double, double, std::vector<double>&)> observable_gradient;
 };
 
 #endif
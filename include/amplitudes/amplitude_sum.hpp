@@ -24,6 +24,9 @@ namespace jpacPhoto
     // Store a vector of all the amplitudes you want to sum incoherently
     std::vector<amplitude*> _amps;
 
+    // Clones own copies of their constituents and must delete them
+    bool _ownsAmps = false;
+
   public:
     // Empty constructor
     amplitude_sum(reaction_kinematics * xkinem, std::string identifer = "amplitude_sum")
@@ -37,12 +40,25 @@ namespace jpacPhoto
     : amplitude(xkinem, identifer), _amps(vec)
     {
         _isSum = true;
+        count_params();
     };
 
+    ~amplitude_sum()
+    {
+        if (_ownsAmps)
+        {
+            for (int i = 0; i < _amps.size(); i++) delete _amps[i];
+        }
+    };
+
+    // Copy with independent copies of every constituent, NULL if any cannot be copied
+    amplitude * clone();
+
     // Add a new amplitude to the vector
     void add_amplitude(amplitude * new_amp)
     {
       _amps.push_back(new_amp);
+      count_params();
     };
 
     // Add all the members of an existing sum to a new sum
@@ -52,6 +68,13 @@ namespace jpacPhoto
       {
         _amps.push_back(new_sum->_amps[i]);
       }
+      count_params();
+    };
+
+    // Constituents in the order they were added
+    inline std::vector<amplitude*> amplitudes()
+    {
+        return _amps;
     };
 
     // empty allowedJP, leave the checks to the individual amps instead
@@ -60,14 +83,44 @@ namespace jpacPhoto
         return {};
     };
 
-    // TODO: Add a set_params which timesi in one vector and allocates approriaten number of
-    // params to each sub amplitude
+    // Set the parameters of all constituents at once.
+    // The vector is split in the order the amplitudes were added, each taking its own _nParams entries.
+    // If a constituent is changed directly instead, call reset_cache() on the sum as well.
+    void set_params(std::vector<double> params);
 
     // Evaluate the sum for given set of helicites, energy, and cos
     std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double s, double t);
-    
-    // Caching helicity amplitudes is a little different for sums since no parity relations
-    void check_cache(double s, double t);
+
+    // Derivatives are available if they are for every constituent
+    // and are ordered the same way as the parameters in set_params()
+    bool gradient_available();
+    dual helicity_gradient(std::array<int, 4> helicities, double s, double t);
+
+    // Monomials of all constituents in order, only if every constituent is factorizable
+    int n_monomials();
+    std::vector<std::complex<double>> coupling_monomials(std::vector<double> params, double s, double t);
+    std::vector<std::complex<double>> monomial_amplitudes(std::array<int, 4> helicities, double s, double t);
+
+    // Saved inputs of each constituent, each preceded by its length
+    std::vector<std::complex<double>> monomial_kinematics(double s, double t);
+    std::vector<std::complex<double>> saved_coupling_monomials(std::vector<double> params, std::vector<std::complex<double>> kinematics);
+
+    // The sum is nonzero if any of its constituents are
+    bool is_nonzero(std::array<int, 4> helicities);
+
+    // Parity relation may only be used if all the constituents share the same phase
+    int parity_phase(std::array<int, 4> helicities);
+
+    // Resonances of all the constituents
+    std::vector<std::array<double, 2>> resonances();
+
+  private:
+    // Total number of parameters of all constituents
+    inline void count_params()
+    {
+        _nParams = 0;
+        for (int i = 0; i < _amps.size(); i++) _nParams += _amps[i]->_nParams;
+    };
   };
 };
 
@@ -9,6 +9,7 @@
 #define _RESONANCE_
 
 #include "amplitude.hpp"
+#include "wigner_d_matrix.hpp"
 
 // ---------------------------------------------------------------------------
 // baryon_resonance class describes the amplitude corresponding to a narrow
@@ -29,7 +30,8 @@ namespace jpacPhoto
         baryon_resonance(reaction_kinematics * xkinem, int j, int p, double mass, double width, std::string name = "baryon_resonance")
         : amplitude(xkinem, name),
           _mRes(mass), _gamRes(width), 
-          _resJ(j), _resP(p), _naturality(p * pow(-1, (j-1)/2))
+          _resJ(j), _resP(p), _naturality(p * pow(-1, (j-1)/2)),
+          _wigner(j)
         {
             set_nParams(2);
             check_JP(xkinem->_jp);
@@ -61,39 +63,97 @@ namespace jpacPhoto
             };
         };
 
+        // Independent copy for parallel evaluation
+        inline amplitude * clone()
+        {
+            return new baryon_resonance(*this);
+        };
+
         // Setting utility
         void set_params(std::vector<double> params)
         {
             check_nParams(params);
             _xBR = params[0];
             _photoR = params[1];
+            _energy_saved = false;
+
+            // The photocoupling ratio fixes A_3/2 through sqrt(1 - photoR^2)
+            if (std::abs(_photoR) > 1.)
+            {
+                std::cout << "\nWarning! Photocoupling ratio " << _photoR << " passed to " << _identifier << " is outside [-1, 1].\n";
+            }
+            else if (std::abs(_photoR) == 1.)
+            {
+                std::cout << "\nWarning! Derivatives of " << _identifier << " with respect to the photocoupling ratio are infinite at |photoR| = 1.\n";
+            }
+            reset_cache();
         };
 
         // Combined total amplitude including Breit Wigner pole
         std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double s, double t);
 
+        // Derivatives with respect to the branching ratio and photocoupling ratio
+        inline bool gradient_available()
+        {
+            return true;
+        };
+        dual helicity_gradient(std::array<int, 4> helicities, double s, double t);
+
+        // Residues are xBR * photoR for |lam_i| = 1/2 and xBR * sqrt(1 - photoR^2) for |lam_i| = 3/2
+        inline int n_monomials()
+        {
+            return 2;
+        };
+        std::vector<std::complex<double>> coupling_monomials(std::vector<double> params, double s, double t);
+        std::vector<std::complex<double>> monomial_amplitudes(std::array<int, 4> helicities, double s, double t);
+
         // only vector kinematics allowed
         inline std::vector<std::array<int,2>> allowedJP()
         {
             return {{1, -1}};
         };
         
+        // Total helicity in initial and final state cannot exceed the spin of the resonance
+        inline bool is_nonzero(std::array<int, 4> helicities)
+        {
+            if (!amplitude::is_nonzero(helicities)) return false;
+
+            int lam_i = 2 * helicities[0] - helicities[1];
+            int lam_f = 2 * helicities[2] - helicities[3];
+            return (std::abs(lam_i) <= _resJ && std::abs(lam_f) <= _resJ);
+        };
+
         inline int parity_phase(std::array<int, 4> helicities)
         {
             return _kinematics->parity_phase(helicities, HELICITY_CHANNEL::S);
         };
 
+        // Pole of the Breit-Wigner
+        inline std::vector<std::array<double, 2>> resonances()
+        {
+            return {{_mRes, _gamRes}};
+        };
+
         private:
 
         // Photoexcitation helicity amplitude for the process gamma p -> R
+        // (per unit sqrt(xBR) and without the photoR dependence)
         std::complex<double> photo_coupling(int lam_i);
 
         // Hadronic decay helicity amplitude for the R -> J/psi p process
+        // (per unit sqrt(xBR))
         std::complex<double> hadronic_coupling(int lam_f);
 
         // Ad-hoc threshold factor to kill the resonance at threshold
         double threshold_factor(double beta);
 
+        // Everything but the d-function depends only on s and is saved per energy
+        bool _energy_saved = false;
+        double _energy_s = 0., _energy_mX2 = 0.;
+        dual _residues[2]; // photo_coupling x hadronic_coupling x threshold_factor x BW for |lam_i| = 1/2 and 3/2 with derivatives
+        std::complex<double> _structures[2]; // same without the dependence on parameters
+        void update_energy();
+
         int _resJ, _resP, _naturality; // (2xSpin) and parity of the resonance
         double _mRes, _gamRes; // Resonant mass and width
 
@@ -107,6 +167,9 @@ namespace jpacPhoto
         // Initial and final CoM momenta evaluated at resonance energy.
         double _pibar, _pfbar;
 
+        // d-functions for the resonance spin, evaluated for all helicities at once
+        wigner_d_matrix _wigner;
+
         // saved energies and angle
         double _s, _t, _theta;
     };
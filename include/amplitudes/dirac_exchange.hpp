@@ -31,12 +31,19 @@ namespace jpacPhoto
             check_JP(xkinem->_jp);
         };
 
+        // Independent copy for parallel evaluation
+        inline amplitude * clone()
+        {
+            return new dirac_exchange(*this);
+        };
+
         // Setting utility
         void set_params(std::vector<double> params)
         {
             check_nParams(params);
             _gGam = params[0];
             _gVec = params[1];
+            reset_cache();
         };
 
         // Whether or not to include an form factor (default false)
@@ -50,6 +57,13 @@ namespace jpacPhoto
         // Assemble the helicity amplitude by contracting the spinor indices
         std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double s, double t);
 
+        // Spin-summed amplitude squared through Dirac traces
+        inline bool traces_available()
+        {
+            return _useCovariant;
+        };
+        double spin_summed_squared(double s, double t);
+
         inline int parity_phase(std::array<int, 4> helicities)
         {
             return _kinematics->parity_phase(helicities, HELICITY_CHANNEL::S);
@@ -96,6 +110,10 @@ namespace jpacPhoto
 
         // Spin-1/2 propagator
         std::complex<double> dirac_propagator(int i, int j);
+
+        // Product of vertices and propagator as a matrix in spinor space, 
+        // i.e. the amplitude with the external spinors stripped off
+        dirac_matrix vertex_matrix(int lam_gam, int lam_vec, const dirac_matrix & propagator);
     };
 };
 #endif
@@ -41,17 +41,60 @@ namespace jpacPhoto
             check_JP(xkinem->_jp);
         };
 
+        // Independent copy for parallel evaluation
+        inline amplitude * clone()
+        {
+            return new pomeron_exchange(*this);
+        };
+
         // Setting utility
         void set_params(std::vector<double> params)
         {
             check_nParams(params);
             _norm = params[0];
             _b0 = params[1];
+            _factor_saved = false;
+            reset_cache();
         };
 
         // Assemble the helicity amplitude by contracting the lorentz indices
         std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double s, double t);
 
+        // Derivatives with respect to the normalization and t-slope
+        inline bool gradient_available()
+        {
+            return true;
+        };
+        dual helicity_gradient(std::array<int, 4> helicities, double s, double t);
+
+        // A single monomial: the regge_factor times the contraction of the vertices
+        inline int n_monomials()
+        {
+            return 1;
+        };
+        std::vector<std::complex<double>> coupling_monomials(std::vector<double> params, double s, double t);
+        std::vector<std::complex<double>> monomial_amplitudes(std::array<int, 4> helicities, double s, double t);
+
+        // The regge_factor without its parameters: the argument of the exponential (or pole) and everything multiplying it
+        std::vector<std::complex<double>> monomial_kinematics(double s, double t);
+        std::vector<std::complex<double>> saved_coupling_monomials(std::vector<double> params, std::vector<std::complex<double>> kinematics);
+
+        // Spin-summed amplitude squared, only available for the covariant models
+        inline bool traces_available()
+        {
+            return (_model != 1);
+        };
+        double spin_summed_squared(double s, double t);
+
+        // Model 1 is helicity conserving at both vertices
+        inline bool is_nonzero(std::array<int, 4> helicities)
+        {
+            if (!amplitude::is_nonzero(helicities)) return false;
+            if (_model != 1) return true;
+
+            return (helicities[0] == helicities[2] && helicities[1] == helicities[3]);
+        };
+
         inline int parity_phase(std::array<int, 4> helicities)
         {
             return _kinematics->parity_phase(helicities, HELICITY_CHANNEL::S);
@@ -80,8 +123,19 @@ namespace jpacPhoto
         // Nucleon - Nucleon - Pomeron vertex
         std::complex<double> bottom_vertex(int mu, int lam_targ, int lam_rec);
 
-        // Energy dependence from Pomeron propogator
-        std::complex<double> regge_factor();
+        // Parameter independent contraction of the two vertices 
+        std::complex<double> contraction(std::array<int, 4> helicities);
+
+        // Energy dependence from Pomeron propogator for given normalization and t-slope
+        // This contains all the dependence on parameters so it is usually evaluated with derivatives
+        dual regge_factor(dual norm, dual b0);
+
+        // The regge_factor is independent of helicities so it is only calculated 
+        // once per (s, t) point and reused for every helicity amplitude
+        bool _factor_saved = false;
+        double _factor_s = 0., _factor_t = 0., _factor_mX2 = 0.;
+        dual _factor = 0.;
+        dual saved_regge_factor();
     };
 };
 
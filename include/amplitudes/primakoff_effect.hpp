@@ -9,6 +9,7 @@
 #define _PRIMAKOFF_
 
 #include "amplitude.hpp"
+#include "tools/checkpoint.hpp"
 
 namespace jpacPhoto
 {
@@ -23,6 +24,12 @@ namespace jpacPhoto
             check_JP(xkinem->_jp);
         };
 
+        // Independent copy for parallel evaluation
+        inline amplitude * clone()
+        {
+            return new primakoff_effect(*this);
+        };
+
         void set_params(std::vector<double> params)
         {
             check_nParams(params); 
@@ -32,6 +39,13 @@ namespace jpacPhoto
             _photonCoupling = params[3];
 
             calculate_norm();
+            reset_cache();
+        };
+
+        // Save form factors to (and reuse them from) a checkpoint, see tools/checkpoint.hpp
+        inline void set_checkpoint(checkpoint * cp)
+        {
+            _checkpoint = cp;
         };
 
         inline void set_LT(int LT)
@@ -52,6 +66,12 @@ namespace jpacPhoto
             return 0.;
         }
 
+        // so they are all treated as vanishing by check_cache()
+        inline bool is_nonzero(std::array<int, 4> helicities)
+        {
+            return false;
+        };
+
         // instead we override the definition of differential_xsection in amplitude.hpp
         double differential_xsection(double s, double t);
         double integrated_xsection(double s);
@@ -80,6 +100,7 @@ namespace jpacPhoto
         // Normalized fourier transform of the above charge_distributions 
         double form_factor(double x);
         double _formFactor; // Form factor at energy t
+        checkpoint * _checkpoint = NULL;
         
         void calculate_norm();     
         double _rho0 = 0.;  // normalizaton
@@ -13,6 +13,7 @@
 
 #include "amplitude.hpp"
 #include "regge_trajectory.hpp"
+#include "reggeon_propagator.hpp"
 
 // ---------------------------------------------------------------------------
 // pseudoscalar_exchange class describes the amplitude for a spin-0 exchange
@@ -44,18 +45,25 @@ namespace jpacPhoto
 
         // constructors for regge exchange
         pseudoscalar_exchange(reaction_kinematics * xkinem, linear_trajectory * traj, std::string name = "pseudoscalar_exchange")
-        : amplitude(xkinem, name), _alpha(traj), _reggeized(true)
+        : amplitude(xkinem, name), _alpha(traj), _reggeon(traj, 0), _reggeized(true)
         {
             set_nParams(2);
             check_JP(xkinem->_jp, true);
         };
 
+        // Independent copy for parallel evaluation
+        inline amplitude * clone()
+        {
+            return new pseudoscalar_exchange(*this);
+        };
+
         // Setting utility
         void set_params(std::vector<double> params)
         {
             check_nParams(params);
             _gGamma = params[0];
             _gNN = params[1];
+            reset_cache();
         };
 
         // Whether or not to include an exponential form factor (default false)
@@ -68,6 +76,15 @@ namespace jpacPhoto
         // Assemble the helicity amplitude by contracting the spinor indices
         std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double xs, double xt);
 
+        // Analytic residues are helicity conserving at both vertices
+        inline bool is_nonzero(std::array<int, 4> helicities)
+        {
+            if (!amplitude::is_nonzero(helicities)) return false;
+            if (_useCovariant || _debug >= 1) return true;
+
+            return (helicities[0] == helicities[2] && helicities[1] == helicities[3]);
+        };
+
         inline int parity_phase(std::array<int, 4> helicities)
         {
             if (_useCovariant || _debug >= 1)
@@ -108,6 +125,9 @@ namespace jpacPhoto
         // ignored otherwise
         linear_trajectory * _alpha;
 
+        // alpha(t) dependent pieces of the propagator, shared by all helicities at a point
+        reggeon_propagator<linear_trajectory> _reggeon;
+
         // Coupling constants
         double _gGamma = 0.; // Gamma - Axial - Pseudoscalar coupling 
         double _gNN = 0.;    // Pseudoscalar - Nucleon coupling
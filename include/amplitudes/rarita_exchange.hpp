@@ -21,6 +21,12 @@ namespace jpacPhoto
         : dirac_exchange(xkinem, mass, name)
         {};
 
+        // Independent copy for parallel evaluation
+        inline amplitude * clone()
+        {
+            return new rarita_exchange(*this);
+        };
+
         // Assemble the helicity amplitude by contracting the spinor indices
         std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double xs, double xt);
 
@@ -123,6 +123,10 @@ namespace jpacPhoto
         inline double Wth(){ return (_mX + _mR); }; // square root of the threshold
         inline double sth(){ return Wth() * Wth(); }; // final state threshold
 
+        // Invariant mass squared from the lab frame beam energy with a fixed target, and its inverse
+        inline double s_from_Egam(double E){ return _mB2 + _mT2 + 2. * _mT * E; };
+        inline double Egam_from_s(double s){ return (s - _mB2 - _mT2) / (2. * _mT); };
+
         // Change the meson mass
         inline void set_mX(double m)
         {
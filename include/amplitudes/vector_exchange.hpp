@@ -10,6 +10,8 @@
 
 #include "amplitude.hpp"
 #include "regge_trajectory.hpp"
+#include "reggeon_propagator.hpp"
+#include "wigner_d_matrix.hpp"
 
 // ---------------------------------------------------------------------------
 // vector_exchange class describes the amplitude for a fixed-spin-1 exchange
@@ -32,7 +34,7 @@ namespace jpacPhoto
 
         // Constructor for fixed spin
         vector_exchange(reaction_kinematics * xkinem, double mass, std::string id = "vector_exchange")
-        : amplitude(xkinem, id), _mEx2(mass*mass), _ifReggeized(false)
+        : amplitude(xkinem, id), _mEx2(mass*mass), _ifReggeized(false), _wigner(2)
         {
             set_nParams(3);
             check_JP(xkinem->_jp);
@@ -43,12 +45,18 @@ namespace jpacPhoto
 
         // Constructor for the reggized)
         vector_exchange(reaction_kinematics * xkinem, linear_trajectory * traj, std::string id = "vector_exchange")
-        : amplitude(xkinem, id), _alpha(traj), _ifReggeized(true)
+        : amplitude(xkinem, id), _alpha(traj), _reggeon(traj, 1), _ifReggeized(true), _wigner(2)
         {
             set_nParams(3);
             check_JP(xkinem->_jp, true);
         };
 
+        // Independent copy for parallel evaluation
+        inline amplitude * clone()
+        {
+            return new vector_exchange(*this);
+        };
+
         // Setting utility
         inline void set_params(std::vector<double> params)
         {
@@ -56,6 +64,7 @@ namespace jpacPhoto
             _gGam = params[0];
             _gV = params[1];
             _gT = params[2];
+            reset_cache();
         };
 
         // Whether or not to include an exponential form factor (default false)
@@ -68,6 +77,37 @@ namespace jpacPhoto
         // Assemble the helicity amplitude by contracting the lorentz indices
         std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double s, double t);
 
+        // Derivatives with respect to all three couplings
+        inline bool gradient_available()
+        {
+            return true;
+        };
+        dual helicity_gradient(std::array<int, 4> helicities, double s, double t);
+
+        // Amplitude is bilinear, gGam * (gV * B_V + gT * B_T)
+        inline int n_monomials()
+        {
+            return 2;
+        };
+        std::vector<std::complex<double>> coupling_monomials(std::vector<double> params, double s, double t);
+        std::vector<std::complex<double>> monomial_amplitudes(std::array<int, 4> helicities, double s, double t);
+
+        // Spin-summed amplitude squared, only available for covariant evaluation
+        inline bool traces_available()
+        {
+            return (_useCovariant || _debug >= 1);
+        };
+        double spin_summed_squared(double s, double t);
+
+        // Analytic residues forbid double helicity flip
+        inline bool is_nonzero(std::array<int, 4> helicities)
+        {
+            if (!amplitude::is_nonzero(helicities)) return false;
+            if (_useCovariant || _debug >= 1) return true;
+
+            return (std::abs(helicities[0] - helicities[2]) < 2);
+        };
+
         inline int parity_phase(std::array<int, 4> helicities)
         {
             if (_useCovariant || _debug >= 1)
@@ -102,6 +142,9 @@ namespace jpacPhoto
         linear_trajectory * _alpha;
         double _zt;
 
+        // alpha(t) dependent pieces of the propagator, shared by all helicities at a point
+        reggeon_propagator<linear_trajectory> _reggeon;
+
         // Whether using analytic or covariant expression
         bool _useCovariant = false;
 
@@ -113,6 +156,11 @@ namespace jpacPhoto
         // Couplings to the axial-vector/photon and vector/tensor couplings to nucleon
         double _gGam = 0., _gpGam = 0., _gV = 0., _gT = 0.;
 
+        // Functions depending on the couplings are evaluated with T = std::complex<double>
+        // or T = dual to also get derivatives, with the couplings g = {gGam, gV, gT} passed explicitly
+        template<class T>
+        T evaluate(std::array<int, 4> helicities, double s, double t, std::array<double, 3> g);
+
         // ---------------------------------------------------------------------------
         // Covariant evaluation
 
@@ -120,13 +168,19 @@ namespace jpacPhoto
         double _mEx2 = 0.;
 
         // Full covariant amplitude
-        std::complex<double> covariant_amplitude(std::array<int, 4> helicities);
+        template<class T>
+        T covariant_amplitude(std::array<int, 4> helicities, std::array<double, 3> g);
 
         // Photon - Axial Vector - Vector vertex
-        std::complex<double> top_vertex(int mu, int lam_gam, int lam_vec);
+        template<class T>
+        T top_vertex(int mu, int lam_gam, int lam_vec, std::array<double, 3> g);
 
         // Nucleon - Nucleon - Vector vertex
-        std::complex<double> bottom_vertex(int nu, int lam_targ, int lam_rec);
+        template<class T>
+        T bottom_vertex(int nu, int lam_targ, int lam_rec, std::array<double, 3> g);
+
+        // Same as above but as a matrix in spinor space (i.e. without the external spinors)
+        dirac_matrix bottom_vertex_matrix(int nu);
 
         // Vector propogator
         std::complex<double> vector_propagator(int mu, int nu);
@@ -135,14 +189,19 @@ namespace jpacPhoto
         // Analytic evaluation
 
         // Photon - Axial - Vector
-        std::complex<double> top_residue(int lam_gam, int lam_vec);
+        template<class T>
+        T top_residue(int lam_gam, int lam_vec, std::array<double, 3> g);
 
         // Nucleon - Nucleon - Vector
-        std::complex<double> bottom_residue(int lam_targ, int lam_rec);
+        template<class T>
+        T bottom_residue(int lam_targ, int lam_rec, std::array<double, 3> g);
 
         // Reggeon propagator
         std::complex<double> regge_propagator(int j, int lam, int lamp);
 
+        // Spin-1 d-functions in terms of the t-channel scattering angle
+        wigner_d_matrix _wigner;
+
         // Half angle factors
         std::complex<double> half_angle_factor(int lam, int lamp);
 
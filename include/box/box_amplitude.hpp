@@ -12,6 +12,11 @@
 #include "amplitudes/amplitude.hpp"
 #include "amplitudes/reaction_kinematics.hpp"
 #include "box/box_discontinuity.hpp"
+#include "tools/parallel.hpp"
+#include "tools/checkpoint.hpp"
+
+#include <functional>
+#include <limits>
 
 #include <boost/math/quadrature/gauss_kronrod.hpp>
 
@@ -50,6 +55,44 @@ namespace jpacPhoto
             _s_cut = s_cut;
         };
 
+        // The dispersion integral uses the 15-point Gauss-Kronrod rule on intervals which are bisected
+        // up to max_depth times until the Kronrod-Gauss difference is below tol relative to the integral.
+        // The default depth of 0 is a single application of the rule.
+        inline void set_max_depth(int n)
+        {
+            _maxDepth = n;
+        };
+
+        inline void set_tolerance(double tol)
+        {
+            _tolerance = tol;
+        };
+
+        // Save every value of the discontinuity and the resulting helicity amplitudes to (and reuse them from) a checkpoint,
+        // see tools/checkpoint.hpp. Values are labeled by the external helicities and angle, and by the fingerprint of the
+        // discontinuity so changing the sub-amplitudes or integration settings will not reuse old values.
+        // With VEGAS a resumed calculation may learn its grid at a different point, so new values agree
+        // with those of an uninterrupted run within the integration errors.
+        inline void set_checkpoint(checkpoint * cp)
+        {
+            _checkpoint = cp;
+            if (_checkpoint != NULL) _fingerprint = checkpoint::key_hash(_disc->fingerprint());
+        };
+
+        // The box has no parameters of its own, so after changing the sub-amplitudes or the integration settings
+        // of the discontinuity call this so new values are not labeled as the old ones
+        inline void reset_cache()
+        {
+            amplitude::reset_cache();
+            if (_checkpoint != NULL) _fingerprint = checkpoint::key_hash(_disc->fingerprint());
+        };
+
+        // Number of threads evaluating the discontinuity at the nodes of the dispersion integral
+        inline void set_threads(int n)
+        {
+            _nThreads = std::max(1, n);
+        };
+
         // only vector available
         inline std::vector<std::array<int,2>> allowedJP()
         {
@@ -59,6 +102,12 @@ namespace jpacPhoto
         // Evaluate the helicity amplitude by dispersing
         std::complex<double> helicity_amplitude(std::array<int, 4> helicities, double s, double t);
 
+        // The box satisfies the usual s-channel parity relation which halves the number of dispersion integrals needed
+        inline int parity_phase(std::array<int, 4> helicities)
+        {
+            return _kinematics->parity_phase(helicities, HELICITY_CHANNEL::S);
+        };
+
         // Override the jpacPhoto::amplitude::integrated_xsection
         double integrated_xsection(double s);
 
@@ -70,6 +119,33 @@ namespace jpacPhoto
 
         // Integration momentum cutoff. Defaults to 2 GeV (an arbitrary but sensible value)
         double _s_cut = 2.;
+
+        int _maxDepth = 0;
+        double _tolerance = 1.E-6;
+        int _nThreads = get_threads();
+
+        // Saved values are labeled by _key followed by the energy,
+        // where _key starts with the fingerprint of the discontinuity computed in set_checkpoint()
+        checkpoint * _checkpoint = NULL;
+        std::vector<double> _fingerprint, _key;
+        inline std::vector<double> key(double sp)
+        {
+            std::vector<double> result = _key;
+            result.push_back(sp);
+            return result;
+        };
+
+        // Amplitudes also depend on the settings of the dispersion integral and are saved as real (part = 0)
+        // and imaginary (part = 1) parts
+        inline std::vector<double> amplitude_key(double s, int part)
+        {
+            std::vector<double> result = key(s);
+            result.insert(result.end(), {_s_cut, double(_maxDepth), _tolerance, double(part)});
+            return result;
+        };
+
+        // Discontinuity at all nodes, taken from the checkpoint if possible
+        std::vector<double> evaluate_nodes(std::vector<double> nodes, std::vector<box_discontinuity*> & copies);
     };
 };
 
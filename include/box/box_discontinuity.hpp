@@ -12,11 +12,30 @@
 #include "constants.hpp"
 #include "amplitudes/amplitude.hpp"
 #include "amplitudes/reaction_kinematics.hpp"
+#include "tools/parallel.hpp"
+#include "tools/quadrature.hpp"
+#include "tools/amplitude_table.hpp"
+#include "tools/vegas.hpp"
 
 #include "Math/IntegratorMultiDim.h"
 
+#include <cstring>
+
 namespace jpacPhoto
 {
+    // Methods available to integrate over the intermediate phase space
+    // ADAPTIVE (default) uses ROOT::Math::IntegratorMultiDim while VEGAS learns an importance sampling grid
+    // once (see tools/vegas.hpp) and reuses it for every energy and helicity, evaluated in parallel 
+    // on copies of the sub-amplitudes. Since the grid is not adapted again, VEGAS is only faster
+    // when the shape of the integrand changes little between evaluations, check last_error().
+    //
+    // GAUSS_LEGENDRE and SOBOL are fixed rules on the sphere in (cos theta, phi), so every evaluation costs
+    // the same number of calls to the sub-amplitudes at nodes computed once:
+    // GAUSS_LEGENDRE is the product of Gauss-Legendre in cos theta and the trapezoid rule in phi
+    // (which converges exponentially for the periodic dependence on phi), SOBOL uses quasi-random points.
+    // Since the integrand only depends on cos(phi) the nodes only cover phi in [0, pi].
+    enum class BOX_INTEGRATOR { ADAPTIVE, VEGAS, GAUSS_LEGENDRE, SOBOL };
+
     class box_discontinuity
     {
         public: 
@@ -54,6 +73,28 @@ namespace jpacPhoto
             
             // IF they match, get the spin and therefor helicities of the intermediate meson
             _intermediate_helicities = get_helicities(_jp_left[0]);
+
+            _vegas.set_calls(_nCalls);
+            _vegas.set_iterations(5, 2);
+        };
+
+        virtual ~box_discontinuity()
+        {
+            if (_ownsAmps) { delete _initialAmp; delete _finalAmp; };
+        };
+
+        // Independent copy with its own copies of the sub-amplitudes (and the current VEGAS grid) which evaluates serially.
+        // Returns NULL if the sub-amplitudes cannot be cloned
+        virtual box_discontinuity * clone();
+
+        // Hash of the sub-amplitudes and integration settings which determine the values of eval()
+        // used to label saved values (see box_amplitude::set_checkpoint)
+        virtual uint64_t fingerprint();
+
+        // Number of threads used for the phase space integration
+        inline void set_threads(int n)
+        {
+            _nThreads = std::max(1, n);
         };
 
         // Evaluate the discontinuity integrated over intermediate phase space
@@ -68,7 +109,68 @@ namespace jpacPhoto
 
         double _threshold; 
 
+        // Choose the phase space integration method
+        inline void set_integrator(BOX_INTEGRATOR method)
+        {
+            _method = method;
+            _nodes.clear();
+        };
+
+        // Number of nodes of the fixed rules: 
+        // with GAUSS_LEGENDRE n in cos theta times n in phi (default 16), with SOBOL n in total (default 1024, rounded up to a power of two)
+        inline void set_nodes(int n)
+        {
+            _nNodes = n;
+            _nodes.clear();
+        };
+
+        // Number of calls to the integrand per evaluation with the fixed rules
+        inline int N_nodes()
+        {
+            if (_nodes.empty()) make_nodes();
+            return _nodes.size();
+        };
+
+        // Points per iteration of the VEGAS integration (default 4000)
+        inline void set_vegas_calls(int n)
+        {
+            _nCalls = n;
+            _vegas.set_calls(n);
+            _vegas.reset_grid();
+        };
+
+        // Learn the VEGAS grid again at the next evaluation, e.g. after changing the sub-amplitudes
+        inline void reset_grid()
+        {
+            _vegas.reset_grid();
+        };
+
+        // Error estimate of the last evaluation with VEGAS (before multiplying by the phase space)
+        inline double last_error()
+        {
+            return _error;
+        };
+
         private:
+        int _nThreads = get_threads();
+        bool _ownsAmps = false;
+
+        BOX_INTEGRATOR _method = BOX_INTEGRATOR::ADAPTIVE;
+        vegas_integrator _vegas = vegas_integrator(2);
+        int _nCalls = 4000;
+        double _error = 0.;
+
+        // Nodes { cos theta, phi, weight } of the fixed rules
+        int _nNodes = 0;
+        std::vector<std::array<double,3>> _nodes;
+        void make_nodes();
+
+        // Number of consecutive nodes evaluated by one thread at a time
+        int _chunk = 32;
+
+        // Product of sub-amplitudes summed over intermediate helicities at a point in phase space
+        double integrand(amplitude * left, amplitude * right, double s, double cos_gam, double phi_gam);
+
         double _external_theta;
         std::array<int,4> _external_helicities;
 
@@ -94,6 +196,18 @@ namespace jpacPhoto
             if (s < _threshold) return 0.;
             return sqrt(s - _threshold);
         };
+
+        inline box_discontinuity * clone()
+        {
+            return new test_disc(*this);
+        };
+
+        inline uint64_t fingerprint()
+        {
+            uint64_t h;
+            std::memcpy(&h, &_threshold, sizeof(h));
+            return h;
+        };
     };
 };
 
@@ -41,6 +41,10 @@ namespace jpacPhoto
         std::complex<double> component(int i, int lambda, double s, double theta);
         std::complex<double> adjoint_component(int i, int lambda, double s, double theta);
 
+        // Spin sum of u ubar over both helicities, i.e. (pslashed + m)
+        // built out of the components above so phase conventions are consistent
+        dirac_matrix projector(double s, double theta);
+
         private:
 
         // masses, energies, and momenta
@@ -0,0 +1,196 @@
+// Complex dual numbers for forward-mode differentiation with respect to amplitude parameters
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _DUAL_
+#define _DUAL_
+
+#include <complex>
+#include <vector>
+#include <type_traits>
+
+// ---------------------------------------------------------------------------
+// A dual number carries a complex value together with its (complex) derivatives
+// with respect to N real parameters. Arithmetic and elementary functions propagate
+// the derivatives by the chain rule so any function written for std::complex<double>
+// may be evaluated with duals to get its exact gradient in the same pass.
+//
+// Constants have an empty gradient and are treated as having zero derivatives,
+// so the bulk of a calculation (e.g. spinors and polarization vectors which do not depend
+// on parameters) costs nothing extra.
+//
+// Parameters are seeded with seed<T>(value, i, N) which returns the plain value for
+// T = std::complex<double> or the i-th of N independent variables for T = dual.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    class dual
+    {
+        public:
+
+        dual(std::complex<double> x = 0.)
+        : _val(x)
+        {};
+
+        dual(double x)
+        : _val(x)
+        {};
+
+        // Independent variable with value x and index i of N
+        static dual variable(double x, int i, int N)
+        {
+            dual result(x);
+            result._der.assign(N, 0.);
+            result._der[i] = 1.;
+            return result;
+        };
+
+        std::complex<double> _val;
+        std::vector<std::complex<double>> _der;
+
+        inline std::complex<double> value() const { return _val; };
+
+        // Derivative with respect to the i-th parameter
+        inline std::complex<double> derivative(int i) const
+        {
+            return (i < _der.size()) ? _der[i] : 0.;
+        };
+
+        // Compound assignment
+        inline dual & operator+=(const dual & y)
+        {
+            if (_der.size() < y._der.size()) _der.resize(y._der.size(), 0.);
+            for (int i = 0; i < y._der.size(); i++) _der[i] += y._der[i];
+            _val += y._val;
+            return *this;
+        };
+
+        inline dual & operator-=(const dual & y)
+        {
+            if (_der.size() < y._der.size()) _der.resize(y._der.size(), 0.);
+            for (int i = 0; i < y._der.size(); i++) _der[i] -= y._der[i];
+            _val -= y._val;
+            return *this;
+        };
+
+        inline dual & operator*=(const dual & y)
+        {
+            if (_der.size() < y._der.size()) _der.resize(y._der.size(), 0.);
+            for (int i = 0; i < _der.size(); i++)
+            {
+                _der[i] *= y._val;
+                if (i < y._der.size()) _der[i] += _val * y._der[i];
+            }
+            _val *= y._val;
+            return *this;
+        };
+
+        inline dual & operator/=(const dual & y)
+        {
+            if (_der.size() < y._der.size()) _der.resize(y._der.size(), 0.);
+            for (int i = 0; i < _der.size(); i++)
+            {
+                _der[i] /= y._val;
+                if (i < y._der.size()) _der[i] -= _val * y._der[i] / (y._val * y._val);
+            }
+            _val /= y._val;
+            return *this;
+        };
+
+        // Constants only rescale
+        inline dual & operator*=(std::complex<double> c)
+        {
+            for (int i = 0; i < _der.size(); i++) _der[i] *= c;
+            _val *= c;
+            return *this;
+        };
+
+        inline dual & operator/=(std::complex<double> c)
+        {
+            for (int i = 0; i < _der.size(); i++) _der[i] /= c;
+            _val /= c;
+            return *this;
+        };
+
+        inline dual & operator*=(double c){ return (*this *= std::complex<double>(c)); };
+        inline dual & operator/=(double c){ return (*this /= std::complex<double>(c)); };
+
+        // Value f of a function at this point with derivative f'(x) dx
+        inline dual chain(std::complex<double> f, std::complex<double> df) const
+        {
+            dual result(f);
+            result._der = _der;
+            for (int i = 0; i < result._der.size(); i++) result._der[i] *= df;
+            return result;
+        };
+
+        // Elementary functions, only found by argument dependent lookup
+        // so unqualified calls with doubles inside jpacPhoto still go to the std versions
+        friend inline dual exp(const dual & x)
+        {
+            std::complex<double> f = std::exp(x._val);
+            return x.chain(f, f);
+        };
+
+        friend inline dual sqrt(const dual & x)
+        {
+            std::complex<double> f = std::sqrt(x._val);
+            return x.chain(f, 0.5 / f);
+        };
+
+        friend inline dual pow(const dual & x, double n)
+        {
+            return x.chain(std::pow(x._val, n), n * std::pow(x._val, n - 1.));
+        };
+    };
+
+    // ---------------------------------------------------------------------------
+    // Arithmetic
+    inline dual operator-(dual x){ x *= -1.; return x; };
+
+    inline dual operator+(dual x, const dual & y){ return x += y; };
+    inline dual operator-(dual x, const dual & y){ return x -= y; };
+    inline dual operator*(dual x, const dual & y){ return x *= y; };
+    inline dual operator/(dual x, const dual & y){ return x /= y; };
+
+    inline dual operator+(dual x, std::complex<double> c){ x._val += c; return x; };
+    inline dual operator+(std::complex<double> c, dual x){ x._val += c; return x; };
+    inline dual operator-(dual x, std::complex<double> c){ x._val -= c; return x; };
+    inline dual operator-(std::complex<double> c, dual x){ return c + (-x); };
+    inline dual operator*(dual x, std::complex<double> c){ return x *= c; };
+    inline dual operator*(std::complex<double> c, dual x){ return x *= c; };
+    inline dual operator/(dual x, std::complex<double> c){ return x /= c; };
+    inline dual operator/(std::complex<double> c, const dual & x){ return dual(c) / x; };
+
+    inline dual operator+(dual x, double c){ return x + std::complex<double>(c); };
+    inline dual operator+(double c, dual x){ return x + std::complex<double>(c); };
+    inline dual operator-(dual x, double c){ return x - std::complex<double>(c); };
+    inline dual operator-(double c, dual x){ return std::complex<double>(c) - x; };
+    inline dual operator*(dual x, double c){ return x *= c; };
+    inline dual operator*(double c, dual x){ return x *= c; };
+    inline dual operator/(dual x, double c){ return x /= c; };
+    inline dual operator/(double c, const dual & x){ return dual(c) / x; };
+
+    // ---------------------------------------------------------------------------
+    // Promote a parameter to the scalar type used in a calculation
+    template<class T>
+    T seed(double x, int i, int N);
+
+    template<>
+    inline std::complex<double> seed(double x, int i, int N)
+    {
+        return x;
+    };
+
+    template<>
+    inline dual seed(double x, int i, int N)
+    {
+        return dual::variable(x, i, N);
+    };
+};
+
+#endif
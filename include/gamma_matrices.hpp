@@ -10,6 +10,7 @@
 
 #include "constants.hpp"
 
+#include <array>
 #include <complex>
 #include <string>
 #include <vector>
@@ -61,7 +62,22 @@ namespace jpacPhoto
 	// ---------------------------------------------------------------------------
 	// Four dimensional Levi-Civita symbol
 	double levi_civita(int mu, int alpha, int beta, int gamma);
-	
+
+	// ---------------------------------------------------------------------------
+	// Generic 4x4 matrix in spinor space.
+	// Used to build projectors and vertices for spin-summed (trace) evaluations
+	typedef std::array<std::array<std::complex<double>, 4>, 4> dirac_matrix;
+
+	// Matrix product A.B
+	dirac_matrix dirac_product(const dirac_matrix & A, const dirac_matrix & B);
+
+	// Dirac conjugate gamma_0 A^dagger gamma_0
+	dirac_matrix dirac_bar(const dirac_matrix & A);
+
+	// Tr(A.B) and Tr(A.B.C.D) without storing intermediate products
+	std::complex<double> dirac_trace(const dirac_matrix & A, const dirac_matrix & B);
+	std::complex<double> dirac_trace(const dirac_matrix & A, const dirac_matrix & B, const dirac_matrix & C, const dirac_matrix & D);
+
 };
 
 #endif
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <algorithm>
 
 namespace jpacPhoto
 {
@@ -226,6 +227,20 @@ namespace jpacPhoto
         };
     };
 
+    // Unique pairs of helicities of particles i and j appearing in a given set of helicity combinations
+    // e.g. i = 0, j = 2 gives all the (photon, meson) combinations
+    inline std::vector<std::array<int, 2>> get_helicity_pairs(std::vector<std::array<int, 4>> hels, int i, int j)
+    {
+        std::vector<std::array<int, 2>> pairs;
+        for (int n = 0; n < hels.size(); n++)
+        {
+            std::array<int, 2> pair = {hels[n][i], hels[n][j]};
+            if (std::find(pairs.begin(), pairs.end(), pair) == pairs.end()) pairs.push_back(pair);
+        }
+
+        return pairs;
+    };
+
     inline int find_helicity(std::array<int, 4> helicities, int j, double m = 0.)
     {
         std::vector<std::array<int,4>> hels = get_helicities(j, m);
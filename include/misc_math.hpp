@@ -21,8 +21,12 @@ namespace jpacPhoto
         return x*x + y*y + z*z - 2. * (x*y + x*z + y*z);
     };
 
+    // Complex Gamma function (OPT = 0) or its logarithm (OPT = 1)
     std::complex<double> cgamma(std::complex<double> z, int OPT = 0);
 
+    // Same as above evaluated for an array of n arguments at once
+    void cgamma(const std::complex<double> * z, std::complex<double> * result, int n, int OPT = 0);
+
     inline unsigned int factorial(unsigned int n) 
     {
         if (n == 0)
@@ -30,6 +34,9 @@ namespace jpacPhoto
         return n * factorial(n - 1);
     };
 
+    // Factorials as doubles, tabulated once up to 170! (the largest finite double) and infinite beyond
+    double factorial_table(int n);
+
     // ---------------------------------------------------------------------------
     // Wigner d-func coefficient of leading power
     double wigner_leading_coeff(int j, int lam1, int lam2);
@@ -31,6 +31,9 @@ class regge_trajectory
     : _parent(old._parent), _signature(old._signature)
     {};
 
+    // destructor
+    virtual ~regge_trajectory(){};
+
     // Only need a function to evaluate the trajectory at some s
     virtual std::complex<double> eval(double s) = 0;
 
@@ -0,0 +1,106 @@
+// Energy and t dependence of a reggeon exchange, saved per kinematic point
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _REGGEON_PROP_
+#define _REGGEON_PROP_
+
+#include "constants.hpp"
+#include "misc_math.hpp"
+#include "regge_trajectory.hpp"
+
+// ---------------------------------------------------------------------------
+// The reggeon_propagator class evaluates the helicity independent part of
+// a Regge propagator
+//
+//  - alpha'(t) * (signature + exp(-i pi alpha(t))) / 2 * Gamma(n - alpha(t)) * s^alpha(t)
+//
+// where n is fixed by the exchange (1 for vectors, 0 for pseudoscalars).
+// These are recalculated only when s or the value of the trajectory change,
+// such that every helicity amplitude at the same point costs only a multiplication
+// by s^-M. Gamma(n - alpha) and s^alpha are combined as logarithms so that
+// large |alpha| (i.e. large |t|) does not overflow.
+//
+// Templated in the trajectory type so that the common linear_trajectory
+// is evaluated without virtual calls.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    template<class Trajectory = linear_trajectory>
+    class reggeon_propagator
+    {
+        public:
+
+        // Empty constructor for fixed-spin amplitudes which dont need a propagator
+        reggeon_propagator()
+        : _alpha(NULL)
+        {};
+
+        // Trajectory and argument n of the gamma function
+        reggeon_propagator(Trajectory * alpha, int n)
+        : _alpha(alpha), _n(n)
+        {};
+
+        // Regge propagator with the power of s lowered by M
+        inline std::complex<double> eval(double s, double t, int M = 0)
+        {
+            update(s, t);
+
+            std::complex<double> result = _factor;
+            for (int i = 0; i < M; i++) result *= _inv_s;
+
+            return result;
+        };
+
+        // Value of the trajectory at the last point evaluated
+        inline std::complex<double> alpha()
+        {
+            return _alpha_t;
+        };
+
+        private:
+
+        Trajectory * _alpha;
+        int _n = 0;
+
+        // Saved point and corresponding values
+        bool _saved = false;
+        double _s = 0., _inv_s = 0.;
+        int _signature = 0;
+        std::complex<double> _alpha_t = 0., _slope = 0., _factor = 0.;
+
+        // Recalculate only if the point or the trajectory have changed
+        inline void update(double s, double t)
+        {
+            // qualified calls bypass the virtual dispatch
+            std::complex<double> alpha_t = _alpha->Trajectory::eval(t);
+            std::complex<double> slope   = _alpha->Trajectory::slope();
+
+            if (_saved && s == _s && alpha_t == _alpha_t && slope == _slope && _signature == _alpha->_signature) return;
+
+            _s = s; _inv_s = 1. / s;
+            _alpha_t = alpha_t; _slope = slope;
+            _signature = _alpha->_signature;
+            _saved = true;
+
+            _factor = factor(slope, _signature, alpha_t, cgamma(double(_n) - alpha_t, 1), log(s));
+        };
+
+        // Assemble the propagator given log(Gamma(n - alpha)) and log(s)
+        inline std::complex<double> factor(std::complex<double> slope, int signature, std::complex<double> alpha_t,
+                                           std::complex<double> log_gamma, double log_s)
+        {
+            std::complex<double> result;
+            result  = - slope;
+            result *= 0.5 * (double(signature) + exp(-XI * PI * alpha_t));
+            result *= exp(log_gamma + alpha_t * log_s);
+            return result;
+        };
+    };
+};
+
+#endif
@@ -0,0 +1,78 @@
+// Adaptive sampling of one-dimensional curves, e.g. observables as functions of energy
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _ADAPT_SAMPLE_
+#define _ADAPT_SAMPLE_
+
+#include "amplitudes/amplitude.hpp"
+
+#include <functional>
+#include <map>
+#include <vector>
+#include <array>
+
+// ---------------------------------------------------------------------------
+// The adaptive_sampler class replaces a fixed grid of N points (e.g. vec_fill)
+// when plotting functions with narrow structures.
+//
+// Starting from a coarse uniform grid plus any seeded points, each interval is bisected
+// and the midpoint compared to the linear interpolation of its ends.
+// Intervals where the two differ by more than the tolerance (relative to the range of the curve)
+// are refined further, those with the largest difference first,
+// until the tolerance is met everywhere or the maximum number of points is reached.
+//
+// Narrow resonances may fall entirely between two points of the initial grid,
+// so points around known poles and thresholds should be seeded with add_pole() and add_threshold()
+// or all at once from an amplitude with add_structures().
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    class adaptive_sampler
+    {
+        public:
+
+        // Constructor with the function to sample
+        adaptive_sampler(std::function<double(double)> F, double tolerance = 1.E-3, int max_points = 2000)
+        : _F(F), _tolerance(tolerance), _maxPoints(max_points)
+        {};
+
+        // Setting utilities
+        inline void set_tolerance(double tol){ _tolerance = tol; };
+        inline void set_max_points(int N){ _maxPoints = N; };
+
+        // Seed points around a Breit-Wigner pole of given mass and width
+        void add_pole(double mass, double width);
+
+        // Seed points at and just above a threshold
+        void add_threshold(double x);
+
+        // Seed all resonances and the final state threshold of an amplitude.
+        // Assumes the variable being sampled is the CoM energy W
+        void add_structures(amplitude * amp);
+
+        // Sample the function in the interval [xmin, xmax] starting with N uniformly spaced points (at least 2)
+        // Output is in the same format as vec_fill: {x values, f(x) values} sorted in x
+        std::array<std::vector<double>, 2> sample(double xmin, double xmax, int N = 20, bool PRINT = false);
+
+        private:
+
+        std::function<double(double)> _F;
+        double _tolerance;
+        int _maxPoints;
+
+        // Poles as {mass, width} and thresholds to seed
+        std::vector<std::array<double, 2>> _poles;
+        std::vector<double> _thresholds;
+
+        // Sampled points
+        std::map<double, double> _points;
+        void add_point(double x);
+    };
+};
+
+#endif
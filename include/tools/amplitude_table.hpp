@@ -0,0 +1,172 @@
+// Binary tables of helicity amplitudes on a grid which can be memory-mapped by other programs
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _AMP_TABLE_
+#define _AMP_TABLE_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/parallel.hpp"
+
+#include <cstdint>
+#include <fstream>
+
+// ---------------------------------------------------------------------------
+// The amplitude_tabulator class evaluates every helicity amplitude of an amplitude
+// on a uniform grid in either (s, t) or (E_gamma, cos theta) and writes them to a binary file:
+//
+//   amplitude_tabulator tab(&sum);
+//   tab.set_grid(TABLE_GRID::EGAM_COS, {8.5, 11.5, 151}, {-1., 1., 201});
+//   tab.write("jpsi.jptab");
+//
+// The file starts with a table_header holding the grid, the kinematics, the list of helicities
+// (in the order of reaction_kinematics::_helicities) and a fingerprint of the model. The amplitudes
+// follow as std::complex<double> ordered [x][y][helicity], starting at an offset which is a multiple of
+// the page size so the file may be mapped directly. Points outside the physical region are NaN.
+//
+// The amplitude_table class maps such a file read-only, so many processes share one copy in memory,
+// and gives the values at the nodes or interpolated in between:
+//
+//   amplitude_table table("jpsi.jptab");
+//   std::complex<double> A = table.interpolate({1, 1, 1, 1}, 9., 0.5);
+//
+// The fingerprint is a hash of the identifier, masses and quantum numbers of the amplitude and of its helicity
+// amplitudes and cross section at a fixed reference point, so tables made with other models or couplings are recognized with matches().
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    enum class TABLE_GRID { S_T, EGAM_COS };
+
+    // n evenly spaced points from min to max
+    struct table_axis
+    {
+        double min, max;
+        int n;
+
+        inline double node(int i)
+        {
+            return (n > 1) ? min + (max - min) * double(i) / double(n - 1) : min;
+        };
+    };
+
+    // Fixed layout at the start of every file, all fields are 4 or 8 bytes so there is no padding
+    struct table_header
+    {
+        char     magic[8];      // "JPACTAB1"
+        uint32_t version;
+        uint32_t endian;        // 0x01020304 as written, to recognize files from machines with different byte order
+        uint64_t data_offset;   // bytes from the start of the file to the first amplitude
+        uint64_t data_size;     // bytes of amplitudes
+        uint32_t grid;          // TABLE_GRID
+        uint32_t nHelicities;
+        double   xmin, xmax;
+        uint64_t nx;
+        double   ymin, ymax;
+        uint64_t ny;
+        double   masses[4];     // beam, target, produced particle, recoil
+        int32_t  jp[2];         // of the produced particle
+        uint64_t fingerprint;
+        char     identifier[64];
+    };
+
+    // Hash of an amplitude as saved in tables (FNV-1a)
+    uint64_t model_fingerprint(amplitude * amp);
+
+    // ---------------------------------------------------------------------------
+    class amplitude_tabulator
+    {
+        public:
+
+        amplitude_tabulator(amplitude * amp)
+        : _amp(amp)
+        {};
+
+        // x is s (or E_gamma) and y is t (or cos theta)
+        inline void set_grid(TABLE_GRID grid, table_axis x, table_axis y)
+        {
+            _grid = grid; _x = x; _y = y;
+        };
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // Evaluate and write the table, returns false if the file cannot be written
+        bool write(std::string filename);
+
+        private:
+
+        amplitude * _amp;
+        int _nThreads = get_threads();
+
+        TABLE_GRID _grid = TABLE_GRID::S_T;
+        table_axis _x = {0., 0., 1}, _y = {0., 0., 1};
+
+        // Rows of x evaluated in parallel before they are written
+        int _block = 64;
+    };
+
+    // ---------------------------------------------------------------------------
+    class amplitude_table
+    {
+        public:
+
+        // Map a file written by amplitude_tabulator, check is_open() afterwards
+        amplitude_table(std::string filename);
+        ~amplitude_table();
+
+        // The mapping cannot be shared between instances
+        amplitude_table(const amplitude_table &) = delete;
+        amplitude_table & operator=(const amplitude_table &) = delete;
+
+        inline bool is_open(){ return _data != NULL; };
+
+        inline const table_header & header(){ return _header; };
+        inline TABLE_GRID grid(){ return TABLE_GRID(_header.grid); };
+        inline table_axis x_axis(){ return {_header.xmin, _header.xmax, int(_header.nx)}; };
+        inline table_axis y_axis(){ return {_header.ymin, _header.ymax, int(_header.ny)}; };
+        inline std::string identifier(){ return std::string(_header.identifier); };
+
+        inline std::vector<std::array<int, 4>> helicities(){ return _helicities; };
+
+        // Position of a set of helicities in the table or -1 if not found
+        int helicity_index(std::array<int, 4> helicities);
+
+        // Whether the table was made by the same model (and couplings) as amp
+        inline bool matches(amplitude * amp){ return model_fingerprint(amp) == _header.fingerprint; };
+
+        // Value of the k-th helicity amplitude at node (i, j)
+        inline std::complex<double> at(int k, int i, int j)
+        {
+            return _data[(uint64_t(i) * _header.ny + j) * _header.nHelicities + k];
+        };
+
+        // All helicity amplitudes at node (i, j), directly in the mapped file
+        inline const std::complex<double> * at(int i, int j)
+        {
+            return _data + (uint64_t(i) * _header.ny + j) * _header.nHelicities;
+        };
+
+        // Bilinear interpolation of the k-th helicity amplitude in the variables of the grid
+        // NaN outside the grid or next to unphysical nodes
+        std::complex<double> interpolate(int k, double x, double y);
+        inline std::complex<double> interpolate(std::array<int, 4> helicities, double x, double y)
+        {
+            return interpolate(helicity_index(helicities), x, y);
+        };
+
+        private:
+
+        table_header _header;
+        std::vector<std::array<int, 4>> _helicities;
+
+        void * _map = NULL;
+        size_t _mapSize = 0;
+        const std::complex<double> * _data = NULL;
+    };
+};
+
+#endif
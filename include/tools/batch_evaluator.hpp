@@ -0,0 +1,76 @@
+// Evaluation of observables for many parameter sets at once, e.g. for uncertainty bands
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _BATCH_EVAL_
+#define _BATCH_EVAL_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/parallel.hpp"
+
+// ---------------------------------------------------------------------------
+// The batch_evaluator class evaluates an observable at a list of points {s, t} for
+// many parameter vectors (e.g. bootstrap replicas of a fit), given as a structure of arrays
+// params[k][n] = k-th parameter of the n-th set:
+//
+//   batch_evaluator batch(&sum);
+//   batch.set_parameter_sets(params);
+//   std::vector<std::vector<double>> band = batch.bands(&amplitude::differential_xsection, points);
+//
+// For amplitudes which factorize into coupling monomials (see amplitude::n_monomials())
+// the parameter independent structures B_{h,m}(s,t) are evaluated once per point and
+// the helicity amplitudes of all sets are recombined from them with simple loops over the sets.
+// These are then placed in the cache of the amplitude so the observable itself costs only the
+// sums over helicities. Other amplitudes are evaluated for each set in turn.
+// Different points are evaluated in parallel on copies of the amplitude.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    class batch_evaluator
+    {
+        public:
+
+        batch_evaluator(amplitude * amp)
+        : _amp(amp)
+        {};
+
+        // Parameter vectors as params[k][n], every k must have the same number of sets
+        void set_parameter_sets(std::vector<std::vector<double>> params);
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; };
+
+        inline int N_sets(){ return _nSets; };
+
+        // Observable at every point {s, t} for every parameter set, result[i][n]
+        // Afterwards the amplitude is left with the last parameter set, since amplitudes
+        // cannot report their current parameters the previous ones are not restored
+        std::vector<std::vector<double>> eval(observable F, std::vector<std::array<double, 2>> points);
+
+        // Percentiles (in %) of the observable over the parameter sets at every point, result[i][j]
+        // Default is the median and the 68% band
+        std::vector<std::vector<double>> bands(observable F, std::vector<std::array<double, 2>> points, 
+                                               std::vector<double> percentiles = {16., 50., 84.});
+
+        private:
+
+        amplitude * _amp;
+        int _nThreads = get_threads();
+
+        int _nSets = 0;
+        std::vector<std::vector<double>> _params;
+
+        // n-th parameter vector
+        std::vector<double> parameter_set(int n);
+
+        // Observable at one point for all sets on a given copy of the amplitude
+        std::vector<double> eval_factorized(amplitude * amp, observable & F, double s, double t);
+        std::vector<double> eval_direct(amplitude * amp, observable & F, double s, double t);
+    };
+};
+
+#endif
@@ -0,0 +1,80 @@
+// Observables integrated over bins in energy and momentum transfer for comparison with binned data
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _BINNED_OBS_
+#define _BINNED_OBS_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/parallel.hpp"
+#include "tools/quadrature.hpp"
+#include "tools/region_average.hpp"
+
+#include <map>
+
+// ---------------------------------------------------------------------------
+// The binned_observables class takes a list of bins in energy (W or E_gamma) and t
+// and returns in each bin the average differential cross section
+//
+//   < dsigma/dt > = int dE int dt dsigma/dt / int dE int dt
+//
+// together with any number of polarization observables weighted by the cross section
+//
+//   < O > = int dE int dt O dsigma/dt / int dE int dt dsigma/dt
+//
+// Each bin is integrated with a Gauss-Lobatto rule in both variables. Since the rule
+// includes the endpoints, adjacent bins share their edge nodes which are only evaluated once.
+// All observables at a node are evaluated together so the cached helicity amplitudes are reused,
+// and all nodes at the same energy are evaluated together so energy dependent quantities are too.
+// Different energies are evaluated in parallel on copies of the amplitude.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    // Bin edges in energy and t. Either may be collapsed to a single value (e.g. Emin = Emax)
+    struct kinematic_bin
+    {
+        double Emin, Emax;
+        double tmin, tmax;
+    };
+
+    class binned_observables
+    {
+        public:
+
+        // Constructor with amplitude and which energy variable the bins are given in
+        binned_observables(amplitude * amp, ENERGY_VARIABLE evar = ENERGY_VARIABLE::W)
+        : _amp(amp), _evar(evar)
+        {};
+
+        // Number of Gauss-Lobatto nodes per bin in each direction (default 6)
+        inline void set_order(int n){ _order = std::max(2, n); };
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // For every bin returns { <dsigma/dt>, <O_1>, <O_2>, ... } with the observables weighted as above
+        std::vector<std::vector<double>> eval(std::vector<kinematic_bin> bins, std::vector<observable> obs = {});
+
+        // Only the bin averaged differential cross sections
+        std::vector<double> xsections(std::vector<kinematic_bin> bins);
+
+        private:
+
+        amplitude * _amp;
+        ENERGY_VARIABLE _evar;
+
+        int _order = 6, _nThreads = get_threads();
+
+        // Convert the energy variable to s
+        double s_from(double E);
+
+        // Nodes and weights in t of a bin at fixed energy, clipped to the physical region
+        std::array<std::vector<double>, 2> t_nodes(kinematic_bin bin, double s);
+    };
+};
+
+#endif
@@ -0,0 +1,85 @@
+// Persistent store of expensive intermediate values so interrupted calculations can resume
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _CHECKPOINT_
+#define _CHECKPOINT_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// The checkpoint class saves values (e.g. box discontinuities or nuclear form factors)
+// together with the list of numbers they were calculated from to a file, and returns them
+// instead of recalculating when the same key is requested again, also by a later run:
+//
+//   checkpoint cp("D_loop.ckpt");
+//   box.set_checkpoint(&cp);
+//
+// New values are kept in memory and appended to the file every N_flush values (default 64) and
+// when the checkpoint is destroyed, so at most N_flush values are lost if the process is killed.
+// An incomplete value at the end of the file (e.g. from being killed while writing) is ignored.
+// Keys are compared exactly so values are only reused for identical inputs.
+// A single checkpoint may be shared between threads and by several amplitudes.
+//
+// Completed points of a scan are best saved with scan_writer (see tools/scan_writer.hpp)
+// which resumes from the first missing point, while a checkpoint saves the work which went
+// into points which were not completed.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    class checkpoint
+    {
+        public:
+
+        // Open a file and read any values already in it
+        checkpoint(std::string filename, int N_flush = 64);
+
+        ~checkpoint()
+        {
+            flush();
+        };
+
+        // Look up the value saved for key, returns false if there is none
+        bool find(const std::vector<double> & key, double & value);
+
+        // Save a value
+        void save(const std::vector<double> & key, double value);
+
+        // Append all new values to the file
+        void flush();
+
+        // Number of values saved and number read from file when opened
+        inline int size(){ return _values.size(); };
+        inline int N_read(){ return _nRead; };
+
+        // Split a 64-bit hash into two numbers which can be part of a key
+        static inline std::vector<double> key_hash(uint64_t h)
+        {
+            return {double(h >> 32), double(h & 0xFFFFFFFF)};
+        };
+
+        private:
+
+        std::string _filename;
+        int _nFlush;
+        int _nRead = 0;
+
+        std::mutex _mutex;
+        std::map<std::vector<double>, double> _values;
+
+        // Values not yet written
+        std::vector<std::pair<std::vector<double>, double>> _new;
+        void write_new();
+    };
+};
+
+#endif
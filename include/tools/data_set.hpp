@@ -0,0 +1,131 @@
+// Experimental data points bound to the observable they measure
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _DATA_SET_
+#define _DATA_SET_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/region_average.hpp"
+
+#include <fstream>
+#include <sstream>
+
+// ---------------------------------------------------------------------------
+// A data_set holds measured values of a single observable, e.g.
+//
+//   data_set dxs("GlueX dsigma/dt", &amplitude::differential_xsection, ENERGY_VARIABLE::EGAM);
+//   dxs.set_gradient(&amplitude::differential_xsection_gradient); // optional
+//   dxs.load("gluex_dxs.dat");
+//
+// Data files are whitespace separated columns with lines starting with # ignored.
+// Lines have four columns { E, t, value, error }, or three { E, value, error } for
+// data sets of observables depending only on energy, e.g. &amplitude::integrated_xsection
+// (which is then evaluated with t = 0). Files where any line does not match are not loaded.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    struct data_point
+    {
+        double E, t;
+        double value, error;
+    };
+
+    class data_set
+    {
+        public:
+
+        data_set(std::string id, observable F, ENERGY_VARIABLE evar = ENERGY_VARIABLE::W)
+        : _identifier(id), _F(F), _evar(evar)
+        {};
+
+        // Observables which only depend on energy
+        data_set(std::string id, double (amplitude::*F)(double), ENERGY_VARIABLE evar = ENERGY_VARIABLE::W)
+        : _identifier(id), _evar(evar), _tIntegrated(true)
+        {
+            _F = [F](amplitude * amp, double s, double t){ return (amp->*F)(s); };
+        };
+
+        std::string _identifier;
+        observable _F;
+        ENERGY_VARIABLE _evar;
+
+        // Whether the observable is independent of t
+        bool _tIntegrated = false;
+
+        // Optionally the same observable with derivatives, used by the fitter when available
+        observable_gradient _dF;
+        inline void set_gradient(observable_gradient dF){ _dF = dF; };
+
+        std::vector<data_point> _points;
+
+        inline void add_point(double E, double t, double value, double error)
+        {
+            _points.push_back({E, t, value, error});
+        };
+
+        inline void add_point(double E, double value, double error)
+        {
+            if (!_tIntegrated && !_points.empty())
+            {
+                std::cout << "data_set: Point without t added to " << _identifier << " which depends on t. Skipping...\n";
+                return;
+            }
+
+            _tIntegrated = true;
+            _points.push_back({E, 0., value, error});
+        };
+
+        // Read points from file, returns the number of points read
+        inline int load(std::string filename)
+        {
+            std::ifstream infile(filename);
+            if (!infile.is_open())
+            {
+                std::cout << "data_set: Cannot open file " << filename << "!\n";
+                return 0;
+            }
+
+            // Every line needs the columns of this data set, otherwise nothing is added
+            int ncols = (_tIntegrated) ? 3 : 4;
+
+            std::vector<std::vector<double>> rows;
+            std::string line;
+            int l = 0;
+            while (std::getline(infile, line))
+            {
+                l++;
+                if (line.empty() || line[0] == '#') continue;
+
+                std::istringstream iss(line);
+                std::vector<double> cols;
+                double x;
+                while (iss >> x) cols.push_back(x);
+
+                if (cols.empty()) continue;
+                if (cols.size() != ncols)
+                {
+                    std::cout << "data_set: Line " << l << " of " << filename << " has " << cols.size() << " columns but ";
+                    std::cout << _identifier << " expects " << ncols << ". File not loaded!\n";
+                    return 0;
+                }
+
+                rows.push_back(cols);
+            }
+
+            for (int i = 0; i < rows.size(); i++)
+            {
+                if (_tIntegrated) add_point(rows[i][0], rows[i][1], rows[i][2]);
+                else              add_point(rows[i][0], rows[i][1], rows[i][2], rows[i][3]);
+            }
+
+            return rows.size();
+        };
+    };
+};
+
+#endif
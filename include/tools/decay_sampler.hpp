@@ -0,0 +1,132 @@
+// Decay angles of polarized vector mesons sampled from tabulated spin density matrix elements
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _DECAY_SAMPLER_
+#define _DECAY_SAMPLER_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/parallel.hpp"
+#include "tools/region_average.hpp"
+#include "tools/event_generator.hpp"
+
+#include <random>
+
+// ---------------------------------------------------------------------------
+// The decay_sampler class gives the decay angular distribution of a produced vector meson
+//
+//   W(cos theta, phi, Phi) = W^0 - P_gamma cos(2 Phi) W^1 - P_gamma sin(2 Phi) W^2
+//
+//   W^alpha = 3/4pi sum_mu w_mu sum_{lam, lam'} rho^alpha_{lam lam'} D^1*_{lam mu}(phi, theta, -phi) D^1_{lam' mu}(phi, theta, -phi)
+//
+// where Phi is the angle between the photon polarization and the production plane and mu the
+// difference of the helicities of the decay products (mu = 0 for two pseudoscalars
+// and mu = +-1 with equal weights for a massless lepton pair).
+//
+// The SDMEs (with the same conventions as amplitude::SDME) are calculated all at once at
+// each node of a grid in energy (W or E_gamma) and t scaled to [0, 1] at each energy, in parallel,
+// and interpolated linearly after. Decay angles are then sampled by accept/reject for
+// batches of events without evaluating the amplitude, with random streams per chunk of events
+// as in event_generator.hpp so results do not depend on the number of threads.
+//
+// Angles are given in the helicity frame (z along the meson in the CoM frame) or the
+// Gottfried-Jackson frame (z along the beam in the meson rest frame), in both cases with
+// y normal to the production plane.
+//
+// Only vector mesons produced by real photons are supported. For other amplitudes
+// SDME() and distribution() return 0 and sample() returns no angles.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    enum class DECAY_MODE { TWO_PSEUDOSCALARS, LEPTON_PAIR };
+    enum class DECAY_FRAME { HELICITY, GOTTFRIED_JACKSON };
+
+    struct decay_angles
+    {
+        double cos_theta, phi;
+    };
+
+    class decay_sampler
+    {
+        public:
+
+        // Constructor with amplitude and range of energy variable to tabulate
+        decay_sampler(amplitude * amp, double Emin, double Emax, ENERGY_VARIABLE evar = ENERGY_VARIABLE::EGAM,
+                      DECAY_MODE mode = DECAY_MODE::LEPTON_PAIR, DECAY_FRAME frame = DECAY_FRAME::HELICITY)
+        : _amp(amp), _Emin(Emin), _Emax(Emax), _evar(evar), _mode(mode), _frame(frame)
+        {};
+
+        // Number of grid cells in energy and t (default 40 and 40)
+        inline void set_grid(int nE, int nT){ _nE = nE; _nT = nT; _initialized = false; };
+
+        // Degree and angle of linear polarization of the beam in the lab frame (default unpolarized)
+        inline void set_polarization(double P, double angle = 0.){ _P = P; _polAngle = angle; };
+
+        // Seed of the random streams (default 0)
+        inline void set_seed(unsigned long seed){ _seed = seed; };
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // Interpolated SDME rho^alpha_{lam lam'} at s and t in the chosen frame
+        std::complex<double> SDME(int alpha, int lam, int lamp, double s, double t);
+
+        // Angular distribution at s and t for polarization angle Phi
+        // (normalized such that W^0 integrates to 1 over the decay angles)
+        double distribution(double s, double t, double cos_theta, double phi, double Phi);
+
+        // Decay angles for events given as {s, t, Phi}
+        std::vector<decay_angles> sample(std::vector<std::array<double, 3>> events);
+
+        // Decay angles for generated events, with Phi given by the polarization angle
+        // set above relative to the azimuth of the produced meson
+        std::vector<decay_angles> sample(std::vector<generated_event> & events);
+
+        private:
+
+        amplitude * _amp;
+        double _Emin, _Emax;
+        ENERGY_VARIABLE _evar;
+        DECAY_MODE _mode;
+        DECAY_FRAME _frame;
+
+        int _nE = 40, _nT = 40;
+        double _P = 0., _polAngle = 0.;
+        unsigned long _seed = 0;
+        int _nThreads = get_threads();
+        int _chunk = 5000;
+
+        // rho^alpha_{lam lam'} at each node stored as [alpha][lam + 1][lam' + 1]
+        typedef std::array<std::complex<double>, 27> sdme_matrices;
+        std::vector<sdme_matrices> _table;
+
+        // Tabulate the SDMEs if not done yet, false if the amplitude does not produce
+        // a vector meson with a real photon, in which case nothing is evaluated
+        bool _initialized = false;
+        double _lo, _hi;
+        bool initialize();
+
+        // All SDMEs in the helicity frame from the cached amplitudes, rotated to the chosen frame
+        sdme_matrices calculate(amplitude * amp, double s, double t);
+
+        // Linear interpolation of the table
+        sdme_matrices interpolate(double s, double t);
+
+        // Angle of the rotation about y from the helicity to the Gottfried-Jackson frame
+        double frame_rotation(double s, double t);
+
+        // Distribution from rho(Phi) = rho^0 - P cos(2 Phi) rho^1 - P sin(2 Phi) rho^2
+        double distribution(std::array<std::complex<double>, 9> & rho, double cos_theta, double phi);
+        std::array<std::complex<double>, 9> polarized(sdme_matrices & rho, double Phi);
+
+        // Convert between s and the energy variable
+        double s_from(double E);
+        double E_from(double s);
+    };
+};
+
+#endif
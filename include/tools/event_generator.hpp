@@ -0,0 +1,136 @@
+// Unweighted Monte Carlo events distributed according to the differential cross section
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _EVENT_GEN_
+#define _EVENT_GEN_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/parallel.hpp"
+#include "tools/region_average.hpp"
+
+#include <random>
+#include <fstream>
+
+// ---------------------------------------------------------------------------
+// The event_generator class produces unweighted events of gamma p -> X p' 
+// over a range of energy (E_gamma or W) and the full physical range of t, distributed as
+//
+//   flux(E) * dsigma/dt(s, t)
+//
+// where the flux defaults to 1 (i.e. a flat beam spectrum).
+//
+// Events are sampled by accept/reject against a piecewise constant majorant built once
+// on a grid in energy and in t scaled to [0, 1] at each energy. The grid includes nodes at the 
+// s-channel resonances of the amplitude (see amplitude::resonances()) and each cell is
+// bounded by a safety factor times the largest value at its corners, edge midpoints and center.
+// If the majorant is ever exceeded this is counted and reported.
+//
+// Events are generated in chunks of fixed size, each with its own random stream seeded
+// by the global seed and the index of the chunk, so the output only depends on the seed and
+// not on the number of threads. Chunks are evaluated in parallel on copies of the amplitude
+// and written to file in order as they are completed.
+//
+// Four-momenta of the beam, target, X and recoil are given in the lab frame (target at rest) 
+// with z along the beam, or optionally the CoM frame, with a uniform azimuthal angle.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    struct generated_event
+    {
+        double E, s, t;
+
+        // Four-momenta {E, px, py, pz} of the beam, target, X, and recoil baryon
+        std::array<std::array<double, 4>, 4> p;
+    };
+
+    class event_generator
+    {
+        public:
+
+        // Constructor with amplitude and range of energy variable
+        event_generator(amplitude * amp, double Emin, double Emax, ENERGY_VARIABLE evar = ENERGY_VARIABLE::EGAM)
+        : _amp(amp), _Emin(Emin), _Emax(Emax), _evar(evar)
+        {};
+
+        // Beam spectrum as a function of the energy variable (default flat)
+        inline void set_flux(std::function<double(double)> flux){ _flux = flux; _initialized = false; };
+
+        // Number of grid cells of the majorant in energy and t (default 50 and 50)
+        inline void set_grid(int nE, int nT){ _nE = nE; _nT = nT; _initialized = false; };
+
+        // Factor by which the majorant exceeds the largest sampled value in each cell (default 2)
+        inline void set_safety(double f){ _safety = f; _initialized = false; };
+
+        // Seed of the random streams (default 0)
+        inline void set_seed(unsigned long seed){ _seed = seed; };
+
+        // Events given in the CoM frame instead of the lab frame
+        inline void set_CoM_frame(bool CoM = true){ _CoM = CoM; };
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // Generate N events in memory
+        std::vector<generated_event> generate(int N);
+
+        // Generate N events and write them to file, returns the number written.
+        // Binary files hold 19 doubles per event: E, s, t and the four four-momenta as above.
+        // Text files hold the same values with one event per line.
+        long generate(long N, std::string filename, bool binary = true);
+
+        // Fraction of trials accepted, number of times the majorant was exceeded 
+        // and number of trials with a negative or NaN density (always rejected) so far
+        inline double efficiency(){ return (_nTrials > 0) ? double(_nAccepted) / double(_nTrials) : 0.; };
+        inline long N_violations(){ return _nViolations; };
+        inline long N_invalid(){ return _nInvalid; };
+
+        // Total cross section times flux integrated over the range, estimated from all trials so far
+        double integrated_rate();
+
+        private:
+
+        amplitude * _amp;
+        double _Emin, _Emax;
+        ENERGY_VARIABLE _evar;
+        std::function<double(double)> _flux;
+
+        int _nE = 50, _nT = 50;
+        double _safety = 2.;
+        unsigned long _seed = 0;
+        bool _CoM = false;
+        int _nThreads = get_threads();
+
+        // Number of events in each chunk with its own random stream
+        int _chunk = 5000;
+
+        // Majorant over grid cells and its cumulative distribution
+        bool _initialized = false;
+        std::vector<double> _Egrid, _majorant, _cumulative;
+        void initialize();
+
+        // Convert the energy variable to s
+        double s_from(double E);
+
+        // Density in E and x in [0, 1] where t = tmin(E) + x (tmax(E) - tmin(E))
+        double density(amplitude * amp, double E, double x, double & s, double & t);
+
+        // Generate N events passing each chunk to output in order, returns the number generated
+        long run(long N, std::function<void(std::vector<generated_event> &)> output);
+
+        // Generate the n events of chunk k, counting the trials, violations of the majorant and invalid densities
+        std::vector<generated_event> generate_chunk(amplitude * amp, long k, int n, long & trials, long & violations, long & invalid);
+
+        // Fill the four-momenta of an event
+        void four_vectors(generated_event & event, double phi);
+
+        // Running statistics
+        long _nTrials = 0, _nAccepted = 0, _nViolations = 0, _nInvalid = 0;
+    };
+};
+
+#endif
@@ -0,0 +1,191 @@
+// Per-event storage of component helicity amplitudes and reweighting to new couplings
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _EVENT_STORE_
+#define _EVENT_STORE_
+
+#include "amplitudes/amplitude.hpp"
+#include "amplitudes/amplitude_sum.hpp"
+#include "tools/parallel.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+// ---------------------------------------------------------------------------
+// The event_store class saves, for a list of events {s, t}, the helicity amplitudes 
+// of every component of a model (e.g. the constituents of an amplitude_sum)
+//
+//   event_store store(&sum, true);
+//   store.add_events(points);
+//   store.write("events.jpevt");
+//
+// With monomials = true, components which factorize into coupling monomials
+// (see amplitude::n_monomials()) also save the parameter independent structures B_{h,m}.
+// Only helicities which are nonzero for some component are saved.
+//
+// The reweighter class then recombines the stored values to give new weights
+//
+//   w' = w * sum_h |sum_c A'_{c,h}|^2 / sum_h |sum_c A_{c,h}|^2
+//
+// for a subset of the components and/or new parameters of factorizable components,
+// without evaluating the amplitudes again. Coefficients of the monomials which depend on
+// the kinematics (e.g. the Regge factor of pomeron_exchange) are recombined from the
+// parameter independent inputs saved with each event (see amplitude::monomial_kinematics()).
+//
+// Files start with an event_store_header followed by the saved helicities and monomials
+// per component as int32_t, then each event as s, t, w, the values and, for each component
+// with monomials, the number of saved inputs as uint32_t followed by the inputs.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    struct stored_event
+    {
+        double s, t, w;
+
+        // For each component: amplitudes A_h followed by structures B_{h,m} (if any) ordered as [h][m]
+        std::vector<std::complex<double>> values;
+
+        // For each component: inputs of the coefficients, empty if saved without monomials
+        std::vector<std::vector<std::complex<double>>> kinematics;
+    };
+
+    // Fixed layout at the start of every file, all fields are 4 or 8 bytes so there is no padding
+    struct event_store_header
+    {
+        char     magic[8];      // "JPACEVT2"
+        uint32_t version;
+        uint32_t endian;        // 0x01020304 as written, to recognize files from machines with different byte order
+        uint32_t nComponents;
+        uint32_t nActive;       // saved helicities
+        uint64_t nEvents;
+        uint64_t value_size;    // bytes of stored_event::values per event
+    };
+
+    // Independent copies of every component, the k-th thread using copies[c][k]
+    class component_clones
+    {
+        public:
+
+        component_clones(std::vector<amplitude*> components, int n)
+        {
+            for (int c = 0; c < components.size(); c++)
+            {
+                _clones.emplace_back(new amplitude_clones(components[c], n));
+                n = std::min(n, _clones.back()->size());
+            }
+            _nThreads = n;
+        };
+
+        inline int size(){ return _nThreads; };
+
+        inline std::vector<amplitude*> operator[](int k)
+        {
+            std::vector<amplitude*> result;
+            for (int c = 0; c < _clones.size(); c++) result.push_back((*_clones[c])[k]);
+            return result;
+        };
+
+        private:
+
+        std::vector<std::unique_ptr<amplitude_clones>> _clones;
+        int _nThreads = 1;
+    };
+
+    class event_store
+    {
+        public:
+
+        // Store the components of a sum or any list of amplitudes sharing the same kinematics
+        event_store(amplitude_sum * sum, bool monomials = false)
+        : event_store(sum->amplitudes(), monomials)
+        {};
+
+        event_store(std::vector<amplitude*> components, bool monomials = false);
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // Evaluate and save events with given weights (default 1)
+        void add_event(double s, double t, double w = 1.);
+        void add_events(std::vector<std::array<double, 2>> points, std::vector<double> weights = {});
+
+        inline int N_events(){ return _events.size(); };
+        inline void clear(){ _events.clear(); };
+
+        // Binary files, read() requires the same components and settings the file was written with
+        bool write(std::string filename);
+        bool read(std::string filename);
+
+        private:
+
+        friend class reweighter;
+
+        std::vector<amplitude*> _components;
+        int _nThreads = get_threads();
+
+        // Indices in the helicity table of _kinematics which are saved
+        std::vector<int> _active;
+
+        // Number of monomials saved per component (0 if only amplitudes)
+        // and position of each component in stored_event::values
+        std::vector<int> _nMonomials, _offsets;
+        int _size = 0;
+
+        std::vector<stored_event> _events;
+
+        // Fill the values of an event using a given copy of each component
+        void evaluate(std::vector<amplitude*> & components, stored_event & event);
+    };
+
+    // ---------------------------------------------------------------------------
+    class reweighter
+    {
+        public:
+
+        reweighter(event_store * store)
+        : _store(store)
+        {
+            reset();
+        };
+
+        // Use the couplings the events were generated with for all components
+        void reset();
+
+        // Only include the components with these indices (in the order given to event_store)
+        void set_components(std::vector<int> which);
+
+        // New parameters for the c-th component, which needs to have been saved with monomials
+        void set_params(int c, std::vector<double> params);
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; _amps.reset(); };
+
+        // sum_h |A_h|^2 of every event with the current settings
+        std::vector<double> probabilities();
+
+        // New weights of every event relative to the stored ones
+        std::vector<double> weights();
+
+        private:
+
+        event_store * _store;
+        int _nThreads = get_threads();
+
+        // Copies of the components for each thread, made on the first call of probabilities()
+        std::unique_ptr<component_clones> _amps;
+
+        std::vector<bool> _included, _newParams;
+        std::vector<std::vector<double>> _params;
+
+        // sum_h |A_h|^2 of one event with the stored couplings and all components
+        double stored_probability(stored_event & event);
+    };
+};
+
+#endif
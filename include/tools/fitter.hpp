@@ -0,0 +1,136 @@
+// Chi-squared fits of amplitude parameters to data sets using Minuit2
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _FITTER_
+#define _FITTER_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/data_set.hpp"
+#include "tools/parallel.hpp"
+
+#include "Math/Minimizer.h"
+#include "Math/Factory.h"
+#include "Math/Functor.h"
+#include "Math/IFunction.h"
+
+// ---------------------------------------------------------------------------
+// The fitter class minimizes
+//
+//   chi2 = sum_i (F_i(s_i, t_i) - value_i)^2 / error_i^2
+//
+// over all points in all data sets with respect to the parameters of an amplitude
+// (i.e. the vector passed to amplitude::set_params, which for an amplitude_sum is
+// the parameters of all its constituents in order).
+//
+// The kinematics of every point are converted to s and checked against the physical region
+// once when the data is added, and points are sorted in energy so consecutive evaluations
+// reuse quantities saved by the amplitudes. Each evaluation of chi2 is split into
+// chunks of consecutive points which are evaluated in parallel on copies of the amplitude.
+//
+// If the amplitude and observables provide derivatives with respect to the parameters (see dual.hpp)
+// Minuit is given the exact gradient of chi2 instead of using finite differences.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    class fitter
+    {
+        public:
+
+        fitter(amplitude * amp)
+        : _amp(amp)
+        {
+            for (int i = 0; i < _amp->_nParams; i++)
+            {
+                _pars.push_back({"par[" + std::to_string(i) + "]", 0., 0.1, 0., 0., false, false});
+            }
+        };
+
+        ~fitter()
+        {
+            if (_clones != NULL) delete _clones;
+        };
+
+        // Owns the amplitude clones so cannot be copied
+        fitter(const fitter &) = delete;
+        fitter & operator=(const fitter &) = delete;
+
+        // Add data, returns the number of points which are in the physical region
+        int add_data(data_set data);
+
+        // Name, starting value, and step size of the i-th parameter
+        void set_parameter(int i, std::string name, double start, double step = 0.1);
+
+        // Restrict parameter to [lo, hi]
+        void set_limits(int i, double lo, double hi);
+
+        // Keep parameter fixed at value
+        void fix_parameter(int i, double value);
+
+        // Settings of the minimizer
+        inline void set_tolerance(double tol){ _tolerance = tol; };
+        inline void set_max_calls(int n){ _maxCalls = n; };
+        inline void set_print_level(int n){ _printLevel = n; };
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // chi2 for a given set of parameters
+        double chi2(std::vector<double> params);
+
+        // Same as above also filling its gradient
+        // Requires derivatives of the amplitude and of the observable of every data set
+        double chi2(std::vector<double> params, std::vector<double> & gradient);
+        bool gradient_available();
+
+        // Minimize chi2 starting from the values set above. The amplitude is left with the best fit parameters.
+        // Returns the minimum chi2
+        double do_fit();
+
+        // Results of the last fit
+        inline std::vector<double> best_params(){ return _best; };
+        inline std::vector<double> errors(){ return _errors; };
+
+        // Number of points and chi2 per degree of freedom of the last fit
+        inline int N_points(){ return _points.size(); };
+        double chi2_dof();
+
+        private:
+
+        amplitude * _amp;
+        amplitude_clones * _clones = NULL;
+
+        int _nThreads = get_threads();
+        double _tolerance = 1.E-3;
+        int _maxCalls = 100000, _printLevel = 0;
+
+        struct parameter
+        {
+            std::string name;
+            double start, step;
+            double lo, hi;
+            bool limited, fixed;
+        };
+        std::vector<parameter> _pars;
+
+        // All data sets and their points with precomputed kinematics
+        struct fit_point
+        {
+            int set;
+            double s, t;
+            double value, error;
+        };
+        std::vector<data_set> _data;
+        std::vector<fit_point> _points;
+
+        // Number of consecutive points evaluated by one thread at a time
+        int _chunk = 16;
+
+        double _chi2 = 0.;
+        std::vector<double> _best, _errors;
+    };
+};
+
+#endif
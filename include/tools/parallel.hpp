@@ -0,0 +1,69 @@
+// Utilities to evaluate amplitudes in parallel over many kinematic points
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _PARALLEL_
+#define _PARALLEL_
+
+#include "amplitudes/amplitude.hpp"
+
+#include <functional>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Amplitudes save the last evaluated point and cached helicity amplitudes, so
+// each thread needs its own copy. The amplitude_clones class holds one copy per thread
+// (the first being the original) and deletes them when going out of scope.
+//
+// parallel_for() distributes independent tasks over threads. Each task writes
+// only to its own output so results do not depend on the number of threads.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    // Number of threads used by default in all parallel tools
+    // Initially the number of hardware threads available
+    int get_threads();
+    void set_threads(int n);
+
+    // Call task(i, thread) for every i in [0, N) using nThreads threads
+    // thread is in [0, nThreads) and may be used to select e.g. an amplitude clone
+    void parallel_for(int N, int nThreads, std::function<void(int, int)> task);
+
+    class amplitude_clones
+    {
+        public:
+
+        // Make up to n copies of amp. If amp cannot be cloned only the original is available
+        amplitude_clones(amplitude * amp, int n = get_threads());
+
+        ~amplitude_clones()
+        {
+            for (int i = 1; i < _copies.size(); i++) delete _copies[i];
+        };
+
+        // The copies are owned so these cannot be copied themselves
+        amplitude_clones(const amplitude_clones &) = delete;
+        amplitude_clones & operator=(const amplitude_clones &) = delete;
+
+        // Number of independent copies available (i.e. the number of threads to use)
+        inline int size()
+        {
+            return _copies.size();
+        };
+
+        inline amplitude * operator[](int i)
+        {
+            return _copies[i];
+        };
+
+        private:
+
+        std::vector<amplitude*> _copies;
+    };
+};
+
+#endif
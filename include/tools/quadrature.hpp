@@ -0,0 +1,35 @@
+// Fixed quadrature rules shared by the integration tools
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _QUADRATURE_
+#define _QUADRATURE_
+
+#include <vector>
+#include <array>
+
+namespace jpacPhoto
+{
+    // Nodes and weights of the n-point Gauss-Legendre rule on [-1, 1]
+    void gauss_legendre(int n, std::vector<double> & x, std::vector<double> & w);
+
+    // Same as above mapped to the interval [a, b]
+    std::array<std::vector<double>, 2> gauss_legendre(int n, double a, double b);
+
+    // Nodes and weights of the n-point Gauss-Lobatto rule on [-1, 1] (n >= 2)
+    // The endpoints are included so adjacent intervals may share nodes
+    void gauss_lobatto(int n, std::vector<double> & x, std::vector<double> & w);
+
+    // Same as above mapped to the interval [a, b] with the endpoints exactly a and b
+    std::array<std::vector<double>, 2> gauss_lobatto(int n, double a, double b);
+
+    // First n = 2^m points of the two-dimensional Sobol sequence in the unit square (n is rounded up to a power of two).
+    // These form a net with exactly one point in every elementary box of area 1/n, and
+    // are shifted to the centers of their boxes so the set is symmetric and avoids the edges
+    std::vector<std::array<double, 2>> sobol_2d(int n);
+};
+
+#endif
@@ -0,0 +1,106 @@
+// Averages of observables over regions in energy and momentum transfer (or angle)
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _REGION_AVG_
+#define _REGION_AVG_
+
+#include "amplitudes/amplitude.hpp"
+#include "tools/parallel.hpp"
+#include "tools/quadrature.hpp"
+#include "tools/vegas.hpp"
+
+// ---------------------------------------------------------------------------
+// The region_average class calculates
+//
+//   < F > = int dE int dA F(s, t) / int dE int dA
+//
+// for any observable F over a region in energy E (W or the beam energy in the lab frame)
+// and angular variable A (t or the CoM scattering angle theta in radians).
+// The bounds of A are clipped to the physical region at each energy.
+// Either range may be a single value (e.g. Emin = Emax) to average over only one variable.
+//
+// The angular integral is a fixed tensor product of Gauss-Legendre cells, all evaluated at
+// the same energy one after the other so that energy dependent quantities saved by
+// the amplitudes are reused. The energy integral is adaptive: each cell is compared
+// with the sum of its two halves and bisected until the tolerance is met.
+// Cells at each step of refinement are evaluated in parallel on copies of the amplitude.
+//
+// Alternatively both integrals may be done at once with VEGAS (see vegas.hpp) in energy and
+// the angular variable scaled to the physical region at each energy. The grid learned for
+// one region is kept for the following ones.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    enum class ENERGY_VARIABLE { W, EGAM };
+    enum class ANGULAR_VARIABLE { T, THETA };
+
+    class region_average
+    {
+        public:
+
+        // Constructor with amplitude and the choice of variables to average over
+        region_average(amplitude * amp, ENERGY_VARIABLE evar = ENERGY_VARIABLE::W, ANGULAR_VARIABLE avar = ANGULAR_VARIABLE::T)
+        : _amp(amp), _evar(evar), _avar(avar)
+        {};
+
+        // Number of Gauss-Legendre nodes per cell in each direction (default 8)
+        inline void set_order(int n){ _order = n; };
+
+        // Number of initial cells in energy and fixed cells in the angular variable (default 4 and 4)
+        inline void set_cells(int nE, int nA){ _nE = nE; _nA = nA; };
+
+        // Relative tolerance of the energy integration (default 1.E-4)
+        inline void set_tolerance(double tol){ _tolerance = tol; };
+
+        // Number of threads (default get_threads())
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // Use VEGAS with a given number of points per iteration instead of the adaptive quadrature
+        inline void use_vegas(bool VEGAS = true, int calls = 10000)
+        { 
+            _useVegas = VEGAS;
+            _vegas.set_calls(calls);
+            _vegas.reset_grid();
+        };
+
+        // Error estimate of the integral of F in the last average done with VEGAS
+        inline double last_error(){ return _error; };
+
+        // Average of F over [Emin, Emax] x [Amin, Amax]
+        double eval(observable F, double Emin, double Emax, double Amin, double Amax);
+
+        private:
+
+        amplitude * _amp;
+        ENERGY_VARIABLE  _evar;
+        ANGULAR_VARIABLE _avar;
+
+        int _order = 8, _nE = 4, _nA = 4, _nThreads = get_threads();
+        double _tolerance = 1.E-4;
+        int _maxCells = 2048;
+
+        bool _useVegas = false;
+        vegas_integrator _vegas = vegas_integrator(2);
+        double _error = 0.;
+        double vegas_eval(observable & F, double Emin, double Emax, double Amin, double Amax);
+
+        // Convert the energy variable to s
+        double s_from(double E);
+
+        // Physical range [lo, hi] of the angular variable within [Amin, Amax] at fixed s, false if empty
+        bool angular_range(amplitude * amp, double s, double Amin, double Amax, double & lo, double & hi);
+
+        // Integral over the angular variable and its measure at fixed energy
+        std::array<double, 2> angular_integral(amplitude * amp, observable & F, double E, double Amin, double Amax);
+
+        // Integral over [E0, E1] of the angular integrals using the Gauss-Legendre rule
+        std::array<double, 2> cell_integral(amplitude * amp, observable & F, double E0, double E1, double Amin, double Amax);
+    };
+};
+
+#endif
@@ -0,0 +1,144 @@
+// Scans of observables described by a configuration file instead of a dedicated executable
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _SCAN_CONFIG_
+#define _SCAN_CONFIG_
+
+#include "constants.hpp"
+#include "regge_trajectory.hpp"
+#include "amplitudes/reaction_kinematics.hpp"
+#include "amplitudes/amplitude.hpp"
+#include "tools/checkpoint.hpp"
+#include "tools/parallel.hpp"
+#include "tools/scan_writer.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// The scan_config class reads a model and the scans to compute with it from a text file,
+// builds the kinematics, trajectories and amplitudes and evaluates every scan in parallel,
+// streaming the results to data files (see tools/scan_writer.hpp):
+//
+//   # X(3872) photoproduction near threshold
+//   define      gV_omega  16.
+//   kinematics  kX        mX=M_X3872  jp=1,1
+//   amplitude   X_omega   vector_exchange  kinematics=kX  mass=M_OMEGA  params=8.2E-3,gV_omega,0.  formfactor=1,1.2
+//   amplitude   X_rho     vector_exchange  kinematics=kX  mass=M_RHO    params=3.6E-3,2.4,14.6     formfactor=1,1.4
+//   amplitude   X         sum  of=X_omega,X_rho  label="X(3872)"
+//   scan        X_low.dat amplitudes=X,X_omega  observable=integrated_xsection  W=4.,7.  points=100
+//
+// Each line starts with what it defines and its name, followed by options as key=value.
+// Everything after a # at the start of a word is a comment, values with spaces are given in quotes
+// and a line ending in \ continues on the next.
+// Numbers may be the name of a definition or a mass in constants.hpp (e.g. M_JPSI), and may be
+// multiplied or divided by others (e.g. A*R_psi or 5/2).
+//
+//  define     <name> <number>
+//  kinematics <name> mX=  [mR= mT= mB= (default proton, proton, real photon) Q2=]  jp=J,P
+//  trajectory <name> signature=  intercept=  slope=                                 (linear trajectory)
+//  amplitude  <name> <type>  kinematics=  params=  [label=]                         (plain text identifier, default <name>)
+//             with <type> and additional options:
+//             vector_exchange, pseudoscalar_exchange   mass= or trajectory=  [formfactor=FF,cutoff]
+//             dirac_exchange, rarita_exchange          mass=  [formfactor=FF,cutoff]
+//             pomeron_exchange                         trajectory=  [model=]
+//             baryon_resonance                         J=  P=  mass=  width=   (e.g. J=5/2)
+//             primakoff_effect                         [LT=0,1  checkpoint=<file>]
+//             sum                                      of=<amplitudes>  (kinematics of the first by default)
+//  scan       <file> amplitudes=  observable=  <variable>=min,max  points=  [<fixed>=value]
+//             [format=csv,binary  plot=<gnuplot script>  xlabel=  ylabel=  logy=1]
+//
+// Scans run over one variable, the energy (W, s or Egam) or the angle (theta in degrees, cos or t),
+// with the other fixed (e.g. theta=0. or W=5.). The observable is integrated_xsection, differential_xsection,
+// probability_distribution, A_LL, K_LL, beam_asymmetry_y, beam_asymmetry_4pi or parity_asymmetry.
+// The file has the variable as first column followed by one column per amplitude,
+// with NaN where a point is outside the physical region of an amplitude.
+// Scans are continued if interrupted and may be split between processes with the shard argument of run().
+//
+// Plotting is left to other programs. For CSV scans with plot= a gnuplot script drawing the file is also written.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    // A single scan as given in the configuration file
+    struct scan_spec
+    {
+        std::string filename;
+        std::vector<std::string> amplitudes;
+        std::string observable;
+
+        // Variable scanned over and its range
+        std::string variable;
+        double min, max;
+        long N;
+
+        // The other variable which is held fixed
+        std::string fixed;
+        double value;
+
+        SCAN_FORMAT format = SCAN_FORMAT::CSV;
+
+        // Optional gnuplot script
+        std::string plot, xlabel, ylabel;
+        bool logy = false;
+    };
+
+    class scan_config
+    {
+        public:
+
+        // Read and build everything in a configuration file
+        scan_config(std::string filename);
+
+        ~scan_config();
+
+        // Whether the whole file was read without errors
+        inline bool is_valid(){ return _valid; };
+
+        inline std::vector<scan_spec> scans(){ return _scans; };
+
+        // Amplitude with a given name, NULL if there is none
+        amplitude * get_amplitude(std::string name);
+
+        // Evaluate all scans (or one shard of each) with nThreads threads
+        bool run(int nThreads = get_threads(), scan_shard shard = scan_shard());
+
+        // Assemble the scans after running every shard of nShards
+        bool merge(int nShards);
+
+        private:
+
+        std::string _filename;
+        bool _valid = false;
+
+        std::map<std::string, double> _definitions;
+        std::map<std::string, reaction_kinematics*> _kinematics;
+        std::map<std::string, linear_trajectory*> _trajectories;
+        std::map<std::string, amplitude*> _amplitudes;
+        std::vector<checkpoint*> _checkpoints;
+        std::vector<scan_spec> _scans;
+
+        // Set by the reading functions with the first problem found on the current line
+        std::string _error;
+
+        double number(std::string expression);
+        std::vector<double> numbers(std::string list);
+
+        // Read one line split into words, returns false if there was an error
+        bool read_line(std::vector<std::string> words, std::map<std::string, std::string> options);
+        amplitude * make_amplitude(std::string type, reaction_kinematics * kinem, std::string label, std::map<std::string, std::string> & options);
+        bool check_scan(scan_spec & scan);
+
+        // Convert the point x of a scan into s and t for an amplitude, false if it is outside the physical region
+        bool kinematics(scan_spec & scan, amplitude * amp, double x, double & s, double & t);
+
+        void write_plot(scan_spec & scan);
+    };
+};
+
+#endif
@@ -0,0 +1,161 @@
+// Streaming output of long scans in fixed-size chunks which can be resumed after interruption
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _SCAN_WRITER_
+#define _SCAN_WRITER_
+
+#include "tools/parallel.hpp"
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// The scan_writer class writes the results of a scan over points i = 0, 1, ..., N-1 to file
+// as they are computed instead of collecting whole curves in memory (as with vec_fill):
+//
+//   scan_writer out("sigma.scan", {"E", "sigma"});
+//   int done = out.open();          // points already in the file from an earlier run
+//   stream_scan(out, N, get_threads(), [&](int i, int thread)
+//   {
+//       double E = Emin + i * dE;
+//       return std::vector<double>{E, amps[thread]->integrated_xsection(s_from(E))};
+//   });
+//
+// Points may be added in any order (e.g. by a parallel scan) and are kept in a reorder buffer
+// until all preceding points have arrived, so the file always holds the first points of the scan in order.
+// These are written every chunk points and flushed, so at most one chunk and the buffer are lost if the process dies.
+//
+// In BINARY format each chunk is stored by columns: { first index, number of points } followed by the values
+// of each column in turn. With CSV there is one line per point after a line with the column names.
+// Opening an existing file discards any incomplete chunk (or line) at its end and continues after the last complete one.
+// Files are read back with read_scan().
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    enum class SCAN_FORMAT { BINARY, CSV };
+
+    class scan_writer
+    {
+        public:
+
+        scan_writer(std::string filename, std::vector<std::string> columns, SCAN_FORMAT format = SCAN_FORMAT::BINARY, int chunk = 256)
+        : _filename(filename), _columns(columns), _format(format), _chunk(std::max(1, chunk))
+        {};
+
+        ~scan_writer()
+        {
+            close();
+        };
+
+        // Open the file, continuing an existing one if resume = true.
+        // Returns the number of points already written, or -1 if the file cannot be used
+        // (e.g. it has different columns)
+        long open(bool resume = true);
+
+        // Save the values of point i, may be called from several threads at once
+        void add(long i, std::vector<double> values);
+
+        // Write everything which is complete, including a last partial chunk
+        void close();
+
+        // Number of points in the file and next one expected
+        inline long N_written(){ return _written; };
+
+        inline std::vector<std::string> columns(){ return _columns; };
+
+        private:
+
+        std::string _filename;
+        std::vector<std::string> _columns;
+        SCAN_FORMAT _format;
+        int _chunk;
+
+        std::ofstream _out;
+        std::mutex _mutex;
+        long _written = 0;
+
+        // Points which arrived before some preceding point
+        std::map<long, std::vector<double>> _pending;
+
+        // Points in order waiting to be written as a chunk
+        std::vector<std::vector<double>> _buffer;
+        void write_buffer();
+
+        // Check an existing file and return the number of points and bytes which are complete
+        long resume_binary(long & bytes);
+        long resume_csv(long & bytes);
+    };
+
+    // ---------------------------------------------------------------------------
+    // Evaluate task(i, thread) for every point not yet in the file in parallel and stream the results.
+    // Opens the writer if needed and closes it at the end
+    void stream_scan(scan_writer & out, long N, int nThreads, std::function<std::vector<double>(long, int)> task);
+
+    // Contents of a file written by scan_writer (of either format)
+    struct scan_data
+    {
+        std::vector<std::string> names;
+        SCAN_FORMAT format = SCAN_FORMAT::BINARY;
+
+        // columns[k][i] is the k-th value of point i
+        std::vector<std::vector<double>> columns;
+    };
+
+    scan_data read_scan(std::string filename);
+
+    // ---------------------------------------------------------------------------
+    // Very large scans may also be split between several processes (e.g. batch jobs sharing a filesystem).
+    // The points are divided into nShards contiguous ranges and each process computes one of them into its own file:
+    //
+    //   // job k of 8
+    //   sharded_scan("sigma.scan", {"E", "sigma"}, N, scan_shard(k, 8), get_threads(), task);
+    //
+    //   // once all are done
+    //   merge_shards("sigma.scan", N, 8);
+    //
+    // The task receives the index of the point in the full scan, so results do not depend on the number of shards.
+    // Each shard is resumed like any other scan and can be run again independently (e.g. after a job was killed).
+    // The merge checks that every shard is present, complete and has the same columns before writing anything,
+    // and concatenates them in order so the result is identical to an unsharded scan.
+
+    struct scan_shard
+    {
+        scan_shard(int i = 0, int n = 1)
+        : index(i), N(n)
+        {};
+
+        int index, N;
+
+        inline bool valid(){ return N > 0 && index >= 0 && index < N; };
+
+        // Points first, ..., last - 1 of a scan with nPoints in total belong to this shard
+        inline long first(long nPoints){ return nPoints * index / N; };
+        inline long last(long nPoints) { return nPoints * (index + 1) / N; };
+    };
+
+    // Parse a shard given as "index/N" (e.g. from the command line), with index counting from 0
+    scan_shard parse_shard(std::string shard);
+
+    // Name of the file holding one shard, e.g. sigma.scan.3-of-8
+    std::string shard_filename(std::string filename, scan_shard shard);
+
+    // Compute the points of one shard, continuing an existing shard file
+    void sharded_scan(std::string filename, std::vector<std::string> columns, long N, scan_shard shard, int nThreads,
+                      std::function<std::vector<double>(long, int)> task,
+                      SCAN_FORMAT format = SCAN_FORMAT::BINARY, int chunk = 256);
+
+    // Assemble the shards of a scan with N points into filename in the format of the shards.
+    // Returns false, without writing, if any shard is missing, incomplete or does not match the others
+    bool merge_shards(std::string filename, long N, int nShards, int chunk = 256);
+};
+
+#endif
@@ -0,0 +1,105 @@
+// VEGAS adaptive importance sampling for multi-dimensional integrals
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _VEGAS_
+#define _VEGAS_
+
+#include "tools/parallel.hpp"
+
+#include <array>
+#include <functional>
+#include <random>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// The vegas_integrator class estimates integrals over a hyper-rectangle by Monte Carlo
+// with points distributed according to a separable grid which is adapted to the integrand
+// (G. P. Lepage, J. Comput. Phys. 27 (1978) 192).
+//
+// The grid is kept in the unit hyper-cube and learned once, during the first call to integrate(),
+// by a number of adapting iterations whose results are discarded. Following calls reuse the grid
+// directly so integrals of similar shape (e.g. at neighboring energies or for other helicities)
+// only pay for the final iterations. The grid is forgotten with reset_grid().
+//
+// Points are generated and evaluated in batches in parallel. The integrand receives a whole batch
+// at once together with the index of the thread so it may use e.g. its own amplitude_clones.
+// Each batch has its own random stream determined by the seed and the index of the batch, so results
+// do not depend on the number of threads and repeated calls use the same points. 
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    struct vegas_result
+    {
+        double value, error;
+
+        // chi2 per degree of freedom of the estimates of the final iterations
+        double chi2_dof;
+    };
+
+    class vegas_integrator
+    {
+        public:
+
+        vegas_integrator(int dim = 1)
+        : _dim(dim)
+        {
+            reset_grid();
+        };
+
+        // Integrand for a batch of n points x[i*dim + k], filling f[i]
+        typedef std::function<void(int n, const double * x, double * f, int thread)> batch_integrand;
+
+        // Integral of F over [lower, upper]
+        vegas_result integrate(batch_integrand F, std::vector<double> lower, std::vector<double> upper);
+
+        // Same with an integrand evaluated one point at a time
+        vegas_result integrate(std::function<double(const double *, int)> f, std::vector<double> lower, std::vector<double> upper);
+
+        // Points per iteration (default 10000)
+        inline void set_calls(int n){ _nCalls = std::max(n, 2); };
+
+        // Number of iterations used to learn the grid and to estimate the integral (default 5 and 3)
+        inline void set_iterations(int adapt, int final){ _nAdapt = adapt; _nFinal = std::max(final, 1); };
+
+        // Number of grid bins per dimension and the damping of their adaptation (default 50 and 1.5)
+        inline void set_bins(int n){ _nBins = std::max(n, 1); reset_grid(); };
+        inline void set_damping(double alpha){ _alpha = alpha; };
+
+        // Number of points evaluated together (default 256)
+        inline void set_batch(int n){ _batch = std::max(n, 1); };
+
+        inline void set_seed(unsigned long seed){ _seed = seed; };
+        inline void set_threads(int n){ _nThreads = n; };
+
+        // Forget the learned grid
+        void reset_grid();
+        inline bool trained(){ return _trained; };
+
+        private:
+
+        int _dim;
+        int _nCalls = 10000, _nAdapt = 5, _nFinal = 3;
+        int _nBins = 50, _batch = 256;
+        double _alpha = 1.5;
+        unsigned long _seed = 0;
+        int _nThreads = get_threads();
+
+        // Bin edges in [0, 1] for each dimension
+        std::vector<std::vector<double>> _edges;
+        bool _trained = false;
+
+        // One iteration returning {integral, variance} and filling the sums of (f * jacobian)^2 in each bin
+        std::array<double, 2> iteration(batch_integrand & F, std::vector<double> & lower, std::vector<double> & upper, 
+                                        int k, std::vector<std::vector<double>> & d);
+
+        // Move the bin edges so each bin contributes equally
+        void adapt(std::vector<std::vector<double>> & d);
+    };
+};
+
+#endif
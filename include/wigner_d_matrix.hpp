@@ -0,0 +1,83 @@
+// Wigner little-d matrix for arbitrary spin
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#ifndef _WIGNER_MATRIX_
+#define _WIGNER_MATRIX_
+
+#include "misc_math.hpp"
+
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// The wigner_d_matrix class evaluates all elements d^j_{lam1, lam2} for a
+// given spin at once. Spin and helicities are always given multiplied by two
+// (as in wigner_d_half) such that integer and half-integer spins are treated the same.
+//
+// USING WIKIPEDIA SIGN CONVENTION
+// The matrix is built by Risbo's recurrence which adds one spin 1/2 at a time,
+// only multiplying by the half-angle functions and square roots (tabulated on construction).
+// This remains accurate for large spin where the explicit sum over factorials cancels catastrophically.
+// ---------------------------------------------------------------------------
+
+namespace jpacPhoto
+{
+    class wigner_d_matrix
+    {
+        public:
+
+        // Constructor for spin j given as 2j
+        wigner_d_matrix(int two_j = 0);
+
+        // Evaluate the whole matrix at angle theta (in radians)
+        void update(double theta);
+
+        // or in terms of the cosine of theta.
+        // Careful because this loses the +- phase of the sintheta,
+        // and outside [-1, 1] elements become complex
+        void update_cos(std::complex<double> cosine);
+
+        // Element d^j_{lam1, lam2} of the last evaluated matrix with lam1 = 2 * lambda and lam2 = 2 * lambda^prime
+        inline std::complex<double> operator()(int lam1, int lam2) const
+        {
+            if (std::abs(lam1) > _j || std::abs(lam2) > _j || (_j - lam1) % 2 != 0 || (_j - lam2) % 2 != 0) return 0.;
+
+            return _d[index(lam1, lam2)];
+        };
+
+        inline int two_j() const
+        {
+            return _j;
+        };
+
+        private:
+
+        int _j;
+
+        // rows and columns are ordered from lam = +j to lam = -j
+        // after a first row and column of zeros used by the recurrence
+        inline int index(int lam1, int lam2) const
+        {
+            return ((_j - lam1) / 2 + 1) * (_j + 2) + (_j - lam2) / 2 + 1;
+        };
+
+        // Square roots of 0, ..., 2j used by the recurrence
+        std::vector<double> _roots;
+
+        // Last evaluated matrix and the argument it was evaluated at
+        std::vector<std::complex<double>> _d;
+
+        // Matrix of the previous spin during the recurrence
+        std::vector<std::complex<double>> _last;
+        bool _useCos = false, _saved = false;
+        std::complex<double> _arg = 0.;
+
+        // Recurrence in the spin given the half-angle functions
+        void evaluate(std::complex<double> coshalf, std::complex<double> sinhalf);
+    };
+};
+
+#endif
@@ -11,14 +11,229 @@
 // Evaluate the sum for given set of helicites, and mandelstam invariant s and t
 std::complex<double> jpacPhoto::amplitude_sum::helicity_amplitude(std::array<int, 4> helicities, double s, double t)
 {
+    int index = find_helicity(helicities, _kinematics->_jp[0], _kinematics->_mB);
+
     std::complex<double> result = 0.;
     for (int i = 0; i < _amps.size(); i++)
     {
-        int index = find_helicity(helicities, _kinematics->_jp[0], _kinematics->_mB);
-
         _amps[i]->check_cache(s, t);
+
+        // Skip amplitudes which are known to vanish
+        if (!_amps[i]->_helicity_mask[index]) continue;
+
         result += _amps[i]->_cached_helicity_amplitude[index];
     }
 
     return result;
 };
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::amplitude_sum::gradient_available()
+{
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        if (!_amps[i]->gradient_available()) return false;
+    }
+
+    return true;
+};
+
+// Sum of constituents with each derivative placed at the position of its parameter
+jpacPhoto::dual jpacPhoto::amplitude_sum::helicity_gradient(std::array<int, 4> helicities, double s, double t)
+{
+    int index = find_helicity(helicities, _kinematics->_jp[0], _kinematics->_mB);
+
+    dual result = 0.;
+    result._der.assign(_nParams, 0.);
+
+    int offset = 0;
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        _amps[i]->check_dual_cache(s, t);
+
+        if (_amps[i]->_helicity_mask[index])
+        {
+            dual & amp_i = _amps[i]->_cached_dual_amplitude[index];
+
+            result._val += amp_i._val;
+            for (int k = 0; k < _amps[i]->_nParams; k++) result._der[offset + k] += amp_i.derivative(k);
+        }
+
+        offset += _amps[i]->_nParams;
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+int jpacPhoto::amplitude_sum::n_monomials()
+{
+    int n = 0;
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        int n_i = _amps[i]->n_monomials();
+        if (n_i == 0) return 0;
+
+        n += n_i;
+    }
+
+    return n;
+};
+
+// Split the parameters between the constituents the same way as set_params()
+std::vector<std::complex<double>> jpacPhoto::amplitude_sum::coupling_monomials(std::vector<double> params, double s, double t)
+{
+    std::vector<std::complex<double>> result;
+
+    auto start = params.begin();
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        std::vector<double> params_i(start, start + _amps[i]->_nParams);
+        start += _amps[i]->_nParams;
+
+        std::vector<std::complex<double>> c_i = _amps[i]->coupling_monomials(params_i, s, t);
+        result.insert(result.end(), c_i.begin(), c_i.end());
+    }
+
+    return result;
+};
+
+std::vector<std::complex<double>> jpacPhoto::amplitude_sum::monomial_amplitudes(std::array<int, 4> helicities, double s, double t)
+{
+    std::vector<std::complex<double>> result;
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        std::vector<std::complex<double>> B_i;
+
+        // Skip amplitudes which are known to vanish
+        if (_amps[i]->is_nonzero(helicities)) B_i = _amps[i]->monomial_amplitudes(helicities, s, t);
+        else                                  B_i.assign(_amps[i]->n_monomials(), 0.);
+
+        result.insert(result.end(), B_i.begin(), B_i.end());
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Inputs of the constituents are concatenated with their lengths so they can be split again
+std::vector<std::complex<double>> jpacPhoto::amplitude_sum::monomial_kinematics(double s, double t)
+{
+    std::vector<std::complex<double>> result;
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        std::vector<std::complex<double>> k_i = _amps[i]->monomial_kinematics(s, t);
+
+        result.push_back(double(k_i.size()));
+        result.insert(result.end(), k_i.begin(), k_i.end());
+    }
+
+    return result;
+};
+
+std::vector<std::complex<double>> jpacPhoto::amplitude_sum::saved_coupling_monomials(std::vector<double> params, std::vector<std::complex<double>> kinematics)
+{
+    std::vector<std::complex<double>> result;
+
+    auto start   = params.begin();
+    auto k_start = kinematics.begin();
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        std::vector<double> params_i(start, start + _amps[i]->_nParams);
+        start += _amps[i]->_nParams;
+
+        int n_i = int(std::real(*k_start));
+        std::vector<std::complex<double>> k_i(k_start + 1, k_start + 1 + n_i);
+        k_start += 1 + n_i;
+
+        std::vector<std::complex<double>> c_i = _amps[i]->saved_coupling_monomials(params_i, k_i);
+        result.insert(result.end(), c_i.begin(), c_i.end());
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Common parity phase of all constituents or 0 if they are not consistent
+int jpacPhoto::amplitude_sum::parity_phase(std::array<int, 4> helicities)
+{
+    if (_amps.size() == 0) return 0;
+
+    int eta = _amps[0]->parity_phase(helicities);
+    for (int i = 1; i < _amps.size(); i++)
+    {
+        if (_amps[i]->parity_phase(helicities) != eta) return 0;
+    }
+
+    return eta;
+};
+
+// ---------------------------------------------------------------------------
+// Clone every constituent so the copy shares no state with the original
+jpacPhoto::amplitude * jpacPhoto::amplitude_sum::clone()
+{
+    std::vector<amplitude*> copies;
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        amplitude * copy = _amps[i]->clone();
+        if (copy == NULL)
+        {
+            for (int j = 0; j < copies.size(); j++) delete copies[j];
+            return NULL;
+        }
+        copies.push_back(copy);
+    }
+
+    amplitude_sum * result = new amplitude_sum(*this);
+    result->_amps = copies;
+    result->_ownsAmps = true;
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Split the parameters between the constituents in order
+void jpacPhoto::amplitude_sum::set_params(std::vector<double> params)
+{
+    check_nParams(params);
+    if (params.size() != _nParams) return;
+
+    auto start = params.begin();
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        std::vector<double> params_i(start, start + _amps[i]->_nParams);
+        _amps[i]->set_params(params_i);
+        start += _amps[i]->_nParams;
+    }
+
+    reset_cache();
+};
+
+// ---------------------------------------------------------------------------
+// Collect the resonances of all constituents
+std::vector<std::array<double, 2>> jpacPhoto::amplitude_sum::resonances()
+{
+    std::vector<std::array<double, 2>> result;
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        std::vector<std::array<double, 2>> res_i = _amps[i]->resonances();
+        result.insert(result.end(), res_i.begin(), res_i.end());
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Helicity amplitude is nonzero if any of the constituents are 
+bool jpacPhoto::amplitude_sum::is_nonzero(std::array<int, 4> helicities)
+{
+    int index = find_helicity(helicities, _kinematics->_jp[0], _kinematics->_mB);
+
+    for (int i = 0; i < _amps.size(); i++)
+    {
+        if (_amps[i]->_helicity_mask.size() != _amps[i]->_kinematics->_nAmps) _amps[i]->update_mask();
+        if (_amps[i]->_helicity_mask[index]) return true;
+    }
+
+    return false;
+};
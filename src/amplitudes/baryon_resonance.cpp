@@ -7,6 +7,8 @@
 
 #include "amplitudes/baryon_resonance.hpp"
 
+#include <limits>
+
 // Combined amplitude as a Breit-Wigner with the residue as the prodect of hadronic and photo-couplings
 std::complex<double> jpacPhoto::baryon_resonance::helicity_amplitude(std::array<int, 4> helicities, double s, double t)
 {
@@ -16,17 +18,94 @@ std::complex<double> jpacPhoto::baryon_resonance::helicity_amplitude(std::array<
     // update save values of energies and angle
     _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
 
-    std::complex<double> residue = 1.;
-    residue  = photo_coupling(lam_i);
-    residue *= hadronic_coupling(lam_f);
-    residue *= threshold_factor(1.5);
+    update_energy();
+
+    std::complex<double> residue;
+    residue = (std::abs(lam_i) == 1) ? _residues[0].value() : _residues[1].value();
+    if (lam_f < 0) residue *= double(_naturality);
+
+    _wigner.update(_theta);
+    residue *= _wigner(lam_i, lam_f);
+
+    return residue;
+};
+
+// Same as above with derivatives with respect to {xBR, photoR} which are carried by the saved residues
+jpacPhoto::dual jpacPhoto::baryon_resonance::helicity_gradient(std::array<int, 4> helicities, double s, double t)
+{
+    int lam_i = 2 * helicities[0] - helicities[1];
+    int lam_f = 2 * helicities[2] - helicities[3];
+
+    _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
+
+    update_energy();
 
-    residue *= wigner_d_half(_resJ, lam_i, lam_f, _theta);
-    residue /= (s + XI * _mRes * _gamRes - _mRes*_mRes);
+    dual residue;
+    residue = (std::abs(lam_i) == 1) ? _residues[0] : _residues[1];
+    if (lam_f < 0) residue *= double(_naturality);
+
+    _wigner.update(_theta);
+    residue *= _wigner(lam_i, lam_f);
 
     return residue;
 };
 
+// Each helicity amplitude has only one of the two structures
+std::vector<std::complex<double>> jpacPhoto::baryon_resonance::coupling_monomials(std::vector<double> params, double s, double t)
+{
+    // Same as the residues, no real A_3/2 outside |photoR| <= 1
+    std::complex<double> c3 = (std::abs(params[1]) <= 1.) ? params[0] * sqrt(1. - params[1] * params[1])
+                                                          : std::numeric_limits<double>::quiet_NaN();
+
+    return {params[0] * params[1], c3};
+};
+
+std::vector<std::complex<double>> jpacPhoto::baryon_resonance::monomial_amplitudes(std::array<int, 4> helicities, double s, double t)
+{
+    int lam_i = 2 * helicities[0] - helicities[1];
+    int lam_f = 2 * helicities[2] - helicities[3];
+
+    _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
+
+    update_energy();
+
+    _wigner.update(_theta);
+    std::complex<double> angular = _wigner(lam_i, lam_f);
+    if (lam_f < 0) angular *= double(_naturality);
+
+    std::vector<std::complex<double>> result = {0., 0.};
+    (std::abs(lam_i) == 1) ? (result[0] = angular * _structures[0]) : (result[1] = angular * _structures[1]);
+
+    return result;
+};
+
+// Recalculate the couplings, threshold factor, and Breit-Wigner only if the energy has changed
+void jpacPhoto::baryon_resonance::update_energy()
+{
+    if (_energy_saved && _energy_s == _s && _energy_mX2 == _kinematics->_mX2) return;
+
+    std::complex<double> common;
+    common  = hadronic_coupling(1);
+    common *= threshold_factor(1.5);
+    common /= (_s + XI * _mRes * _gamRes - _mRes*_mRes);
+
+    // Both couplings are proportional to sqrt(xBR) so the residues are linear in it
+    // while photoR sets the relative size of A_1/2 and A_3/2
+    dual xBR    = dual::variable(_xBR,    0, 2);
+    dual photoR = dual::variable(_photoR, 1, 2);
+
+    _structures[0] = photo_coupling(1) * common;
+    _structures[1] = photo_coupling(3) * common;
+
+    _residues[0] = xBR * photoR * _structures[0];
+    // Outside |photoR| <= 1 there is no real A_3/2
+    _residues[1] = (std::abs(_photoR) <= 1.) ? xBR * sqrt(1. - photoR * photoR) * _structures[1]
+                                              : dual(std::numeric_limits<double>::quiet_NaN());
+
+    _energy_s = _s; _energy_mX2 = _kinematics->_mX2;
+    _energy_saved = true;
+};
+
 // Ad-hoc threshold factor to kill the resonance at threshold
 double jpacPhoto::baryon_resonance::threshold_factor(double beta)
 {
@@ -37,17 +116,14 @@ double jpacPhoto::baryon_resonance::threshold_factor(double beta)
 };
 
 // Photoexcitation helicity amplitude for the process gamma p -> R
+// per unit sqrt(xBR) and without the factor of photoR or sqrt(1 - photoR^2)
 std::complex<double> jpacPhoto::baryon_resonance::photo_coupling(int lam_i)
 {
     // For spin-1/2 exchange no double flip
     if (_resJ == 1 && abs(lam_i) > 1) return 0.;
 
-    // A_1/2 or A_3/2 depending on ratio R_photo
-    double a;
-    (std::abs(lam_i) == 1) ? (a = _photoR) : (a = sqrt(1. - _photoR * _photoR));
-
     // Electromagnetic decay width given by VMD assumption
-    std::complex<double> emGamma = (_xBR * _gamRes) * pow(F_JPSI / M_JPSI, 2.);
+    std::complex<double> emGamma = _gamRes * pow(F_JPSI / M_JPSI, 2.);
     emGamma *= pow(XR * _pibar / _pfbar, double(2 * _lmin + 1)) * _pt;
 
     // Photo-coupling overall size of |A_1/2|^2 + |A_3/2|^2 is restriced from VMD
@@ -56,7 +132,7 @@ std::complex<double> jpacPhoto::baryon_resonance::photo_coupling(int lam_i)
 
     std::complex<double> result = sqrt(XR * _s) * _pibar / _mRes;
     result *= sqrt(XR * 8. * M_PROTON * _mRes / _kinematics->_initial_state->momentum(_s));
-    result *= A_lam * a;
+    result *= A_lam;
 
     // FACTOR OF 4 PI SOMETIMES FACTORED OUT
     result *= sqrt(4. * PI * ALPHA);
@@ -65,11 +141,12 @@ std::complex<double> jpacPhoto::baryon_resonance::photo_coupling(int lam_i)
 };
 
 // Hadronic decay helicity amplitude for the R -> J/psi p process
+// per unit sqrt(xBR)
 std::complex<double> jpacPhoto::baryon_resonance::hadronic_coupling(int lam_f)
 {
     // Hadronic coupling constant g, given in terms of branching ratio xBR
     std::complex<double> g;
-    g  = 8. * PI * _xBR * _gamRes;
+    g  = 8. * PI * _gamRes;
     g *=  _mRes * _mRes * double(_resJ + 1) / 6.;
     g /= pow(_pfbar, double(2 * _lmin + 1));
     g = sqrt(XR * g);
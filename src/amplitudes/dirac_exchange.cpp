@@ -23,6 +23,71 @@ std::complex<double> jpacPhoto::dirac_exchange::helicity_amplitude(std::array<in
     return result;
 };
 
+//------------------------------------------------------------------------------
+// Spin-summed amplitude squared
+// sum |A|^2 = sum_{lam_gam, lam_vec} Tr( O P_target Obar P_recoil )
+// with O the amplitude stripped of the external spinors
+double jpacPhoto::dirac_exchange::spin_summed_squared(double s, double t)
+{
+    // Store the invariant energies to avoid having to pass them around 
+    _s = s; _t = t, _theta = _kinematics->theta_s(s, t);
+    _u = _kinematics->u_man(s, _theta);
+
+    dirac_matrix P_target = _kinematics->_target->projector(_s, PI);          // theta_target = pi
+    dirac_matrix P_recoil = _kinematics->_recoil->projector(_s, _theta + PI); // theta_recoil = theta + pi
+
+    // Propagator doesnt depend on helicities
+    dirac_matrix propagator;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            propagator[i][j] = dirac_propagator(i, j);
+        }
+    }
+
+    std::vector<std::array<int,2>> meson_hels = get_helicity_pairs(_kinematics->_helicities, 0, 2);
+
+    double result = 0.;
+    for (int n = 0; n < meson_hels.size(); n++)
+    {
+        dirac_matrix O = vertex_matrix(meson_hels[n][0], meson_hels[n][1], propagator);
+        result += real(dirac_trace(O, P_target, dirac_bar(O), P_recoil));
+    }
+
+    return result * pow(form_factor(), 2.);
+};
+
+//------------------------------------------------------------------------------
+// (epsilon-slashed) S (epsilon*-slashed) with couplings
+jpacPhoto::dirac_matrix jpacPhoto::dirac_exchange::vertex_matrix(int lam_gam, int lam_vec, const dirac_matrix & propagator)
+{
+    dirac_matrix top, bottom;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            top[i][j] = _gGam * slashed_eps(i, j, lam_gam, _kinematics->_eps_gamma, false, _s, 0.); // theta_gamma = 0
+
+            if (_kinematics->_jp == VECTOR)
+            {
+                bottom[i][j] = _gVec * XI * slashed_eps(i, j, lam_vec, _kinematics->_eps_vec, true, _s, _theta); //theta_vec = theta
+            }
+            else if (_kinematics->_jp == PSEUDO_SCALAR)
+            {
+                bottom[i][j] = _gVec * XI * GAMMA_5[i][j];
+            }
+            else
+            {
+                bottom[i][j] = 0.;
+            }
+        }
+    }
+
+    return dirac_product(top, dirac_product(propagator, bottom));
+};
+
+//------------------------------------------------------------------------------
 double jpacPhoto::dirac_exchange::form_factor()
 {
     switch (_useFF)
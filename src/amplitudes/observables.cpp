@@ -13,7 +13,8 @@
 void jpacPhoto::amplitude::check_cache(double s, double t)
 {
     // check if saved version its the one we want
-    if (  (abs(_cached_s - s) < 0.00001) && 
+    if (  (_cached_helicity_amplitude.size() == _kinematics->_nAmps) &&
+          (abs(_cached_s - s) < 0.00001) && 
           (abs(_cached_t - t) < 0.00001) &&
           (abs(_cached_mX2 - _kinematics->_mX2) < 0.00001) // important to make sure the value of mX2 hasnt chanced since last time
        )
@@ -25,21 +26,29 @@ void jpacPhoto::amplitude::check_cache(double s, double t)
         _cached_helicity_amplitude.clear();
 
         int n = _kinematics->_nAmps;
+
+        // Sums depend on the masks and phases of their constituents so always rebuild
+        if (_isSum || _helicity_mask.size() != n) 
+        {
+            update_mask();
+            update_parity();
+        }
         
-        // If this is a single helicity ampltiude we can use the parity relation to only calculate half of the amplitudes
-        if (!_isSum)
+        // If we know the parity phase for every helicity, we can use the parity relation to only calculate half of the amplitudes
+        if (_useParity)
         {
 
             for (int i = 0; i < n/2; i++)
             {
-                std::complex<double> amp_gamp = helicity_amplitude(_kinematics->_helicities[i], s, t);
+                std::complex<double> amp_gamp = 0.;
+                if (_helicity_mask[i]) amp_gamp = helicity_amplitude(_kinematics->_helicities[i], s, t);
                 _cached_helicity_amplitude.push_back(amp_gamp);
             };
 
             for (int i = 0; i < n/2; i++)
             {
                 std::complex<double> amp_gamp = _cached_helicity_amplitude[n/2 - 1 - i];
-                double eta = double(parity_phase(_kinematics->_helicities[i]));
+                double eta = double(_parity_phases[n/2 - 1 - i]);
                 _cached_helicity_amplitude.push_back( eta * amp_gamp);
             };
         }
@@ -47,7 +56,8 @@ void jpacPhoto::amplitude::check_cache(double s, double t)
         {
             for (int i = 0; i < n; i++)
             {
-                std::complex<double> amp_gamp = helicity_amplitude(_kinematics->_helicities[i], s, t);
+                std::complex<double> amp_gamp = 0.;
+                if (_helicity_mask[i]) amp_gamp = helicity_amplitude(_kinematics->_helicities[i], s, t);
                 _cached_helicity_amplitude.push_back(amp_gamp);
             };
         };
@@ -65,16 +75,99 @@ void jpacPhoto::amplitude::check_cache(double s, double t)
     return;
 };
 
+// ---------------------------------------------------------------------------
+void jpacPhoto::amplitude::set_cache(double s, double t, std::vector<std::complex<double>> amplitudes)
+{
+    int n = _kinematics->_nAmps;
+
+    if (_isSum || _helicity_mask.size() != n) 
+    {
+        update_mask();
+        update_parity();
+    }
+
+    _cached_helicity_amplitude.clear();
+
+    if (_useParity && amplitudes.size() == n/2)
+    {
+        _cached_helicity_amplitude = amplitudes;
+        for (int i = 0; i < n/2; i++)
+        {
+            double eta = double(_parity_phases[n/2 - 1 - i]);
+            _cached_helicity_amplitude.push_back(eta * amplitudes[n/2 - 1 - i]);
+        }
+    }
+    else if (amplitudes.size() == n)
+    {
+        _cached_helicity_amplitude = amplitudes;
+    }
+    else
+    {
+        std::cout << "Warning! Invalid number of helicity amplitudes (" << amplitudes.size() << ") passed to the cache of " << _identifier << ".\n";
+        return;
+    }
+
+    _cached_mX2 = _kinematics->_mX2; _cached_s = s; _cached_t = t;
+};
+
+// ---------------------------------------------------------------------------
+// Same as check_cache() but with amplitudes carrying derivatives
+void jpacPhoto::amplitude::check_dual_cache(double s, double t)
+{
+    int n = _kinematics->_nAmps;
+    if (  (_cached_dual_amplitude.size() == n) &&
+          (abs(_cached_dual_s - s) < 0.00001) && 
+          (abs(_cached_dual_t - t) < 0.00001) &&
+          (abs(_cached_dual_mX2 - _kinematics->_mX2) < 0.00001)
+       )
+    {
+        return;
+    }
+
+    _cached_dual_amplitude.clear();
+
+    if (_isSum || _helicity_mask.size() != n) 
+    {
+        update_mask();
+        update_parity();
+    }
+
+    // Parity phases do not depend on parameters so relate derivatives the same way as the amplitudes
+    int n_calc = (_useParity) ? n/2 : n;
+    for (int i = 0; i < n_calc; i++)
+    {
+        dual amp_gamp = 0.;
+        if (_helicity_mask[i]) amp_gamp = helicity_gradient(_kinematics->_helicities[i], s, t);
+        _cached_dual_amplitude.push_back(amp_gamp);
+    }
+
+    if (_useParity)
+    {
+        for (int i = 0; i < n/2; i++)
+        {
+            double eta = double(_parity_phases[n/2 - 1 - i]);
+            _cached_dual_amplitude.push_back(eta * _cached_dual_amplitude[n/2 - 1 - i]);
+        }
+    }
+
+    _cached_dual_mX2 = _kinematics->_mX2; _cached_dual_s = s; _cached_dual_t = t;
+};
+
 // ---------------------------------------------------------------------------
 // Square of the spin averaged amplitude squared
 double jpacPhoto::amplitude::probability_distribution(double s, double t)
 {
+    // Skip the individual helicity amplitudes entirely if possible
+    if (_useTraces && traces_available()) return spin_summed_squared(s, t);
+
     // Check we have the right amplitudes cached
     check_cache(s, t);
 
     double sum = 0.;
     for (int i = 0; i < _kinematics->_nAmps; i++)
     {
+        if (!_helicity_mask[i]) continue;
+
         std::complex<double> amp_i = _cached_helicity_amplitude[i];
         sum += std::real(amp_i * conj(amp_i));
     }
@@ -82,6 +175,35 @@ double jpacPhoto::amplitude::probability_distribution(double s, double t)
     return sum;
 };
 
+// ---------------------------------------------------------------------------
+// Sum of |A|^2 and its derivatives, d|A|^2 / dp = 2 Re[ A^* dA/dp ]
+double jpacPhoto::amplitude::probability_gradient(double s, double t, std::vector<double> & gradient)
+{
+    gradient.assign(_nParams, 0.);
+    if (!gradient_available())
+    {
+        std::cout << "Warning! Derivatives not available for " << _identifier << ". Returning 0!\n";
+        return 0.;
+    }
+
+    check_dual_cache(s, t);
+
+    double sum = 0.;
+    for (int i = 0; i < _kinematics->_nAmps; i++)
+    {
+        if (!_helicity_mask[i]) continue;
+
+        dual & amp_i = _cached_dual_amplitude[i];
+        sum += std::norm(amp_i.value());
+        for (int k = 0; k < _nParams; k++)
+        {
+            gradient[k] += 2. * std::real(conj(amp_i.value()) * amp_i.derivative(k));
+        }
+    }
+
+    return sum;
+};
+
 // ---------------------------------------------------------------------------
 // Differential cross section dsigma / dt
 // in NANOBARN
@@ -98,6 +220,21 @@ double jpacPhoto::amplitude::differential_xsection(double s, double t)
     return norm * sum;
 };
 
+double jpacPhoto::amplitude::differential_xsection_gradient(double s, double t, std::vector<double> & gradient)
+{
+    double sum = probability_gradient(s, t, gradient);
+
+    double norm = 1.;
+    norm /= 64. * PI * s;
+    norm /= real(pow(_kinematics->_initial_state->momentum(s), 2.));
+    norm /= (2.56819E-6); // Convert from GeV^-2 -> nb
+    norm /= 4.; // Average over initial state helicites
+
+    for (int k = 0; k < gradient.size(); k++) gradient[k] *= norm;
+
+    return norm * sum;
+};
+
 // ---------------------------------------------------------------------------
 // Inegrated total cross-section
 // IN NANOBARN
@@ -219,6 +356,9 @@ std::complex<double> jpacPhoto::amplitude::SDME(int alpha, int lam, int lamp, do
     // Normalization (sum over all amplitudes squared)
     double norm = probability_distribution(s, t);
 
+    // Make sure individual amplitudes are available even if the above didnt need them
+    check_cache(s, t);
+
     // k filters first index to be  0, 1, 2
     // l filters second index to be 0, 1, 2
     // m filters sign of second index
@@ -245,6 +385,8 @@ std::complex<double> jpacPhoto::amplitude::SDME(int alpha, int lam, int lamp, do
     {
         int index;
         (alpha == 0) ? (index = iters[0][i]) : (index = iters[1][i]);
+        if (!_helicity_mask[index + k] || !_helicity_mask[iters[0][i] + l + m]) continue;
+
         std::complex<double> amp, amp_star, temp;
         amp      = _cached_helicity_amplitude[index + k];
         amp_star = _cached_helicity_amplitude[iters[0][i] + l + m];
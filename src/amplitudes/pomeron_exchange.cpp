@@ -10,30 +10,112 @@
 // ---------------------------------------------------------------------------
 // Given a set of helicities for each particle, assemble the helicity amplitude by contracting Lorentz indicies
 std::complex<double> jpacPhoto::pomeron_exchange::helicity_amplitude(std::array<int, 4> helicities, double s, double t)
+{
+    // Save energies 
+    _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
+
+    // Helicity independent energy dependence multiplies the whole contraction
+    return contraction(helicities) * saved_regge_factor().value();
+};
+
+// ---------------------------------------------------------------------------
+// Only the regge_factor depends on parameters so the derivatives come from it alone
+jpacPhoto::dual jpacPhoto::pomeron_exchange::helicity_gradient(std::array<int, 4> helicities, double s, double t)
+{
+    _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
+
+    return contraction(helicities) * saved_regge_factor();
+};
+
+// ---------------------------------------------------------------------------
+// The regge_factor for given parameters is the only coefficient
+std::vector<std::complex<double>> jpacPhoto::pomeron_exchange::coupling_monomials(std::vector<double> params, double s, double t)
+{
+    _s = s; _t = t;
+    return {regge_factor(params[0], params[1]).value()};
+};
+
+std::vector<std::complex<double>> jpacPhoto::pomeron_exchange::monomial_amplitudes(std::array<int, 4> helicities, double s, double t)
+{
+    _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
+    return {contraction(helicities)};
+};
+
+// ---------------------------------------------------------------------------
+// Split the regge_factor into the parameter independent parts {x, K}, such that
+// models 0 and 1 give norm * exp(b0 * x) * K and model 2 gives norm * b0^2 * K / (x * (2 b0^2 + x))
+std::vector<std::complex<double>> jpacPhoto::pomeron_exchange::monomial_kinematics(double s, double t)
+{
+    if (s < _kinematics->sth())
+    {
+        std::cout << " \n pomeron_exchange: Trying to evaluate below threshold (sqrt(s) = " << sqrt(s) << ")! Quitting... \n";
+        exit(0);
+    }
+
+    switch (_model)
+    {
+        case 0:
+        case 1:
+        {
+            double t_min = _kinematics->t_man(s, 0.);
+
+            std::complex<double> K = pow(s - _kinematics->sth(), _traj->eval(t)) * XI * E;
+            if (_model == 0) K /= s;
+
+            return {t - t_min, K};
+        }
+        case 2:
+        {
+            double th = pow((_kinematics->_mT + _kinematics->_mR), 2.);
+            double beta_0 = 2.;
+            double etaprime = real(_traj->slope());
+
+            std::complex<double> F_t;
+            F_t  = 3. * beta_0;
+            F_t *= (th - 2.8* t);
+            F_t /= (th - t) *  pow((1. - (t / 0.7)) , 2.);
+
+            std::complex<double> G_p = -XI;
+            G_p  *= pow(XR * etaprime * s, _traj->eval(t) - 1.);
+
+            return {_kinematics->_mX2 - t, - XI * 8. * G_p * F_t * 2. * E * F_JPSI / M_JPSI};
+        }
+        default: return {0., 0.};
+    }
+};
+
+std::vector<std::complex<double>> jpacPhoto::pomeron_exchange::saved_coupling_monomials(std::vector<double> params, std::vector<std::complex<double>> kinematics)
+{
+    if (_model == 2)
+    {
+        double mu2 = params[1] * params[1];
+        return {params[0] * mu2 * kinematics[1] / (kinematics[0] * (2.*mu2 + kinematics[0]))};
+    }
+
+    return {params[0] * exp(params[1] * kinematics[0]) * kinematics[1]};
+};
+
+// ---------------------------------------------------------------------------
+// Contract the top and bottom vertices
+std::complex<double> jpacPhoto::pomeron_exchange::contraction(std::array<int, 4> helicities)
 {
     int lam_gam = helicities[0];
     int lam_targ = helicities[1];
     int lam_vec = helicities[2];
     int lam_rec = helicities[3];
 
-    // Save energies 
-    _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
- 
-    std::complex<double> result = 0.;
-
     // IF using helicity conserving delta fuction model
     if (_model == 1)
     {
-        (lam_gam == lam_vec && lam_rec == lam_targ) ? (result = regge_factor()) : (result = 0.);
-        return result;
+        return (lam_gam == lam_vec && lam_rec == lam_targ) ? 1. : 0.;
     }
 
     // else contract indices
+    std::complex<double> result = 0.;
     for (int mu = 0; mu < 4; mu++)
     {
-        std::complex<double> temp = 1.;
-        temp *= regge_factor();
-        temp *= top_vertex(mu, lam_gam, lam_vec);
+        std::complex<double> temp;
+        temp  = top_vertex(mu, lam_gam, lam_vec);
         temp *= METRIC[mu];
         temp *= bottom_vertex(mu, lam_targ, lam_rec);
 
@@ -43,6 +125,68 @@ std::complex<double> jpacPhoto::pomeron_exchange::helicity_amplitude(std::array<
     return result;
 };
 
+// ---------------------------------------------------------------------------
+// Spin-summed amplitude squared
+// sum |A|^2 = |regge_factor|^2 L^{mu nu} W_{mu nu} 
+// with L the top vertex summed over photon and vector helicities and 
+// W the trace of gamma matrices with the nucleon spin projectors
+double jpacPhoto::pomeron_exchange::spin_summed_squared(double s, double t)
+{
+    // Save energies 
+    _s = s; _t = t; _theta = _kinematics->theta_s(s, t);
+
+    // Top tensor summed over external helicities
+    std::vector<std::array<int,2>> top_hels = get_helicity_pairs(_kinematics->_helicities, 0, 2);
+
+    std::complex<double> L[4][4] = {};
+    for (int n = 0; n < top_hels.size(); n++)
+    {
+        std::complex<double> T[4];
+        for (int mu = 0; mu < 4; mu++)
+        {
+            T[mu] = top_vertex(mu, top_hels[n][0], top_hels[n][1]);
+        }
+
+        for (int mu = 0; mu < 4; mu++)
+        {
+            for (int nu = 0; nu < 4; nu++)
+            {
+                L[mu][nu] += T[mu] * conj(T[nu]);
+            }
+        }
+    }
+
+    // Bottom tensor from traces
+    dirac_matrix P_target = _kinematics->_target->projector(_s, PI);          // target oriented in negative z direction
+    dirac_matrix P_recoil = _kinematics->_recoil->projector(_s, _theta + PI); // recoil oriented an angle theta + pi
+
+    dirac_matrix Gamma[4], Gamma_bar[4];
+    for (int mu = 0; mu < 4; mu++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            for (int j = 0; j < 4; j++) Gamma[mu][i][j] = GAMMA[mu][i][j];
+        }
+        Gamma_bar[mu] = dirac_bar(Gamma[mu]);
+    }
+
+    std::complex<double> result = 0.;
+    for (int mu = 0; mu < 4; mu++)
+    {
+        for (int nu = 0; nu < 4; nu++)
+        {
+            std::complex<double> temp;
+            temp  = L[mu][nu];
+            temp *= METRIC[mu] * METRIC[nu];
+            temp *= dirac_trace(Gamma[mu], P_target, Gamma_bar[nu], P_recoil);
+
+            result += temp;
+        }
+    }
+
+    return std::norm(saved_regge_factor().value()) * real(result);
+};
+
 // ---------------------------------------------------------------------------
 // Bottom vertex coupling the target and recoil proton spinors to the vector pomeron
 std::complex<double> jpacPhoto::pomeron_exchange::bottom_vertex(int mu, int lam_targ, int lam_rec)
@@ -123,9 +267,25 @@ std::complex<double> jpacPhoto::pomeron_exchange::top_vertex(int mu, int lam_gam
     return result;
 };
 
+// ---------------------------------------------------------------------------
+// Only recalculate the regge_factor if the point or parameters have changed since last call
+jpacPhoto::dual jpacPhoto::pomeron_exchange::saved_regge_factor()
+{
+    if (_factor_saved && _factor_s == _s && _factor_t == _t && _factor_mX2 == _kinematics->_mX2)
+    {
+        return _factor;
+    }
+
+    _factor = regge_factor(dual::variable(_norm, 0, 2), dual::variable(_b0, 1, 2));
+    _factor_s = _s; _factor_t = _t; _factor_mX2 = _kinematics->_mX2;
+    _factor_saved = true;
+
+    return _factor;
+};
+
 // ---------------------------------------------------------------------------
 // Usual Regge power law behavior, s^alpha(t) with an exponential fall from the forward direction
-std::complex<double> jpacPhoto::pomeron_exchange::regge_factor()
+jpacPhoto::dual jpacPhoto::pomeron_exchange::regge_factor(dual norm, dual b0)
 {
     if (_s < _kinematics->sth())
     {
@@ -133,25 +293,25 @@ std::complex<double> jpacPhoto::pomeron_exchange::regge_factor()
         exit(0);
     }
 
-    std::complex<double> result = 0.;
+    dual result = 0.;
     
     switch (_model)
     {
         case 0:
         {
             double t_min = _kinematics->t_man(_s, 0.); // t_min = t(theta = 0)
-            result  = exp(_b0 * (_t - t_min));
+            result  = exp(b0 * (_t - t_min));
             result *= pow(_s - _kinematics->sth(), _traj->eval(_t));
-            result *= XI * _norm * E;
+            result *= XI * norm * E;
             result /= _s;
             break;
         }
         case 1:
         {
             double t_min = _kinematics->t_man(_s, 0.); // t_min = t(theta = 0)
-            result  = exp(_b0 * (_t - t_min));
+            result  = exp(b0 * (_t - t_min));
             result *= pow(_s - _kinematics->sth(), _traj->eval(_t));
-            result *= XI * _norm * E;
+            result *= XI * norm * E;
             break;
         }
         case 2:
@@ -160,8 +320,8 @@ std::complex<double> jpacPhoto::pomeron_exchange::regge_factor()
             double th  = pow((_kinematics->_mT + _kinematics->_mR), 2.);
 
             double beta_0 = 2.;           // Pomeron - light quark coupling
-            double beta_c = _norm;        // Pomeron - charm quark coupling
-            double mu2 = _b0 * _b0;       // cutoff parameter 
+            dual beta_c = norm;           // Pomeron - charm quark coupling
+            dual mu2 = b0 * b0;           // cutoff parameter 
             double etaprime = real(_traj->slope());
 
             std::complex<double> F_t;
@@ -15,8 +15,13 @@ double jpacPhoto::primakoff_effect::differential_xsection(double s, double t)
     _s = s; _t = t;
     update_kinematics(); // calculate the other kinematics
 
-    // Form factor
-    _formFactor = form_factor(t);
+    // Form factor (which only depends on t, the target mass and the nuclear parameters)
+    std::vector<double> key = {double(_atomicZ), _atomicRadius, _skinThickness, double(_mA2), t};
+    if (_checkpoint == NULL || !_checkpoint->find(key, _formFactor))
+    {
+        _formFactor = form_factor(t);
+        if (_checkpoint != NULL) _checkpoint->save(key, _formFactor);
+    }
     
     // output
     long double result = 1.;
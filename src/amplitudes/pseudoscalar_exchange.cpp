@@ -241,16 +241,6 @@ std::complex<double> jpacPhoto::pseudoscalar_exchange::scalar_propagator()
     }
     else
     {
-        std::complex<double> alpha_t = _alpha->eval(_t);
-
-        if (std::abs(alpha_t) > 20.) return 0.;
-
-        // Else use the regge propagator
-        std::complex<double> result = 1.;
-        result  = - _alpha->slope();
-        result *= 0.5 * (double(_alpha->_signature) +  exp(-XI * PI * alpha_t));
-        result *= cgamma(0. - alpha_t);
-        result *= pow(_s, alpha_t);
-        return result;
+        return _reggeon.eval(_s, _t);
     }
 };
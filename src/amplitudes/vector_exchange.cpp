@@ -10,6 +10,33 @@
 // ---------------------------------------------------------------------------
 // Assemble the helicity amplitude by contracting the lorentz indices
 std::complex<double> jpacPhoto::vector_exchange::helicity_amplitude(std::array<int, 4> helicities, double s, double t)
+{
+    return evaluate<std::complex<double>>(helicities, s, t, {_gGam, _gV, _gT});
+};
+
+// Same with derivatives with respect to {gGam, gV, gT}
+jpacPhoto::dual jpacPhoto::vector_exchange::helicity_gradient(std::array<int, 4> helicities, double s, double t)
+{
+    return evaluate<dual>(helicities, s, t, {_gGam, _gV, _gT});
+};
+
+// ---------------------------------------------------------------------------
+std::vector<std::complex<double>> jpacPhoto::vector_exchange::coupling_monomials(std::vector<double> params, double s, double t)
+{
+    return {params[0] * params[1], params[0] * params[2]};
+};
+
+// Since the amplitude is linear in each coupling, the derivatives with respect to gV and gT
+// at unit couplings are exactly the two structures
+std::vector<std::complex<double>> jpacPhoto::vector_exchange::monomial_amplitudes(std::array<int, 4> helicities, double s, double t)
+{
+    dual A = evaluate<dual>(helicities, s, t, {1., 1., 1.});
+    return {A.derivative(1), A.derivative(2)};
+};
+
+// ---------------------------------------------------------------------------
+template<class T>
+T jpacPhoto::vector_exchange::evaluate(std::array<int, 4> helicities, double s, double t, std::array<double, 3> g)
 {
     int lam_gam = helicities[0];
     int lam_tar = helicities[1];
@@ -25,11 +52,11 @@ std::complex<double> jpacPhoto::vector_exchange::helicity_amplitude(std::array<i
     _zt = real(_kinematics->z_t(s, _theta));
 
     // Output
-    std::complex<double> result;
+    T result;
 
     if ((_useCovariant == true) || (_debug >= 1))
     {
-        result = covariant_amplitude(helicities);
+        result = covariant_amplitude<T>(helicities, g);
     }
     else
     {
@@ -39,13 +66,14 @@ std::complex<double> jpacPhoto::vector_exchange::helicity_amplitude(std::array<i
         if (abs(lam) == 2) return 0.; // double flip forbidden!
 
         // Product of residues  
-        result  = top_residue(lam_gam, lam_vec);
-        result *= bottom_residue(lam_tar, lam_rec);
+        result  = top_residue<T>(lam_gam, lam_vec, g);
+        result *= bottom_residue<T>(lam_tar, lam_rec, g);
 
         // Pole with d function residue if fixed spin
         if (_ifReggeized == false)
         {
-            result *= wigner_d_int_cos(1, lam, lamp, _zt);
+            _wigner.update_cos(_zt);
+            result *= _wigner(2 * lam, 2 * lamp);
             result /= t - _mEx2;
         }
         // or regge propagator if reggeized
@@ -92,7 +120,8 @@ double jpacPhoto::vector_exchange::form_factor()
 // Analytic residues for Regge form
 
 // Photon coupling
-std::complex<double> jpacPhoto::vector_exchange::top_residue(int lam_gam, int lam_vec)
+template<class T>
+T jpacPhoto::vector_exchange::top_residue(int lam_gam, int lam_vec, std::array<double, 3> g)
 {
     std::complex<double> result = 0.;
     std::complex<double> q_t = sqrt(XR * Kallen(_t, _kinematics->_mX2, _kinematics->_mB2)) / sqrt(4. * _t * XR);
@@ -131,11 +160,12 @@ std::complex<double> jpacPhoto::vector_exchange::top_residue(int lam_gam, int la
         if (_kinematics->_photon) result *=  -4.;
     }
     
-    return _gGam * q_t * result;
+    return seed<T>(g[0], 0, 3) * q_t * result;
 };
 
 // Nucleon - Nucleon - Vector
-std::complex<double> jpacPhoto::vector_exchange::bottom_residue(int lam_tar, int lam_rec)
+template<class T>
+T jpacPhoto::vector_exchange::bottom_residue(int lam_tar, int lam_rec, std::array<double, 3> g)
 {
     std::complex<double> vector, tensor;
     if (lam_tar == lam_rec)
@@ -149,8 +179,8 @@ std::complex<double> jpacPhoto::vector_exchange::bottom_residue(int lam_tar, int
         tensor = sqrt(2.) * sqrt(XR * _t);
     }
 
-    std::complex<double> result;
-    result  = _gV * vector + _gT * tensor;
+    T result;
+    result  = seed<T>(g[1], 1, 3) * vector + seed<T>(g[2], 2, 3) * tensor;
     result *= sqrt(XR * _t - pow((_kinematics->_mT - _kinematics->_mR), 2.)) / sqrt(XR * _t);
     result *= double(lam_tar);
 
@@ -168,27 +198,13 @@ std::complex<double> jpacPhoto::vector_exchange::regge_propagator(int j, int lam
         return 0.;
     }
 
-    std::complex<double> alpha_t = _alpha->eval(_t);
-
-    // the gamma function causes problesm for large t so
-    if (std::abs(alpha_t) > 30.)
-    {
-        return 0.;
-    }
-    else
-    {
-        std::complex<double> result;
-        result  = wigner_leading_coeff(j, lam, lamp);
-        result /= barrier_factor(j, M);
-        result *= half_angle_factor(lam, lamp);
-
-        result *= - _alpha->slope();
-        result *= 0.5 * (double(_alpha->_signature) + exp(-XI * PI * alpha_t));
-        result *= cgamma(1. - alpha_t);
-        result *= pow(_s, alpha_t - double(M));
+    std::complex<double> result;
+    result  = wigner_leading_coeff(j, lam, lamp);
+    result /= barrier_factor(j, M);
+    result *= half_angle_factor(lam, lamp);
+    result *= _reggeon.eval(_s, _t, M);
 
-        return result;
-    }
+    return result;
 };
 
 //------------------------------------------------------------------------------
@@ -221,26 +237,27 @@ std::complex<double> jpacPhoto::vector_exchange::barrier_factor(int j, int M)
 // FEYNMAN EVALUATION
 // ---------------------------------------------------------------------------
 
-std::complex<double> jpacPhoto::vector_exchange::covariant_amplitude(std::array<int, 4> helicities)
+template<class T>
+T jpacPhoto::vector_exchange::covariant_amplitude(std::array<int, 4> helicities, std::array<double, 3> g)
 {
     int lam_gam = helicities[0];
     int lam_tar = helicities[1];
     int lam_vec = helicities[2];
     int lam_rec = helicities[3];
 
-    std::complex<double> result = 0.;
+    T result = 0.;
 
     // Need to contract the Lorentz indices
     for (int mu = 0; mu < 4; mu++)
     {
         for(int nu = 0; nu < 4; nu++)
         {
-            std::complex<double> temp;
-            temp  = top_vertex(mu, lam_gam, lam_vec);
+            T temp;
+            temp  = top_vertex<T>(mu, lam_gam, lam_vec, g);
             temp *= METRIC[mu];
             temp *= vector_propagator(mu, nu);
             temp *= METRIC[nu];
-            temp *= bottom_vertex(nu, lam_tar, lam_rec);
+            temp *= bottom_vertex<T>(nu, lam_tar, lam_rec, g);
 
             result += temp;
         }
@@ -251,7 +268,8 @@ std::complex<double> jpacPhoto::vector_exchange::covariant_amplitude(std::array<
 
 // ---------------------------------------------------------------------------
 // Photon - Axial Vector - Vector vertex
-std::complex<double> jpacPhoto::vector_exchange::top_vertex(int mu, int lam_gam, int lam_vec)
+template<class T>
+T jpacPhoto::vector_exchange::top_vertex(int mu, int lam_gam, int lam_vec, std::array<double, 3> g)
 {
     std::complex<double> result = 0.;
 
@@ -350,12 +368,13 @@ std::complex<double> jpacPhoto::vector_exchange::top_vertex(int mu, int lam_gam,
         }
     }
 
-    return result * _gGam;
+    return result * seed<T>(g[0], 0, 3);
 };
 
 // ---------------------------------------------------------------------------
 // Nucleon - Nucleon - Vector vertex
-std::complex<double> jpacPhoto::vector_exchange::bottom_vertex(int mu, int lam_tar, int lam_rec)
+template<class T>
+T jpacPhoto::vector_exchange::bottom_vertex(int mu, int lam_tar, int lam_rec, std::array<double, 3> g)
 {
     // Vector coupling piece
     std::complex<double> vector = 0.;
@@ -372,9 +391,9 @@ std::complex<double> jpacPhoto::vector_exchange::bottom_vertex(int mu, int lam_t
         }
     }
 
-    // Tensor coupling piece
+    // Tensor coupling piece (always needed for its derivative)
     std::complex<double> tensor = 0.;
-    if (abs(_gT) > 0.001)
+    if (abs(g[2]) > 0.001 || std::is_same<T, dual>::value)
     {
         for (int i = 0; i < 4; i++)
         {
@@ -396,7 +415,7 @@ std::complex<double> jpacPhoto::vector_exchange::bottom_vertex(int mu, int lam_t
         }
     }
 
-    return _gV * vector - _gT * tensor;
+    return seed<T>(g[1], 1, 3) * vector - seed<T>(g[2], 2, 3) * tensor;
 };
 
 // ---------------------------------------------------------------------------
@@ -415,4 +434,120 @@ std::complex<double> jpacPhoto::vector_exchange::vector_propagator(int mu, int n
     result /= _t - _mEx2;
 
     return result;
-};
\ No newline at end of file
+};
+
+// ---------------------------------------------------------------------------
+// SPIN-SUMMED EVALUATION
+// ---------------------------------------------------------------------------
+
+// sum |A|^2 = L^{mu rho} D_{mu nu} W^{nu sigma} D^*_{rho sigma} 
+// with L the top vertex summed over photon and meson helicities and
+// W the trace of the bottom vertex with the nucleon spin projectors
+double jpacPhoto::vector_exchange::spin_summed_squared(double s, double t)
+{
+    // Update the saved energies and angles
+    _s = s; _t = t;
+    if (std::abs(_t) < 1.E-6) _t += EPS;
+    _theta = _kinematics->theta_s(s, t);
+
+    // Top tensor summed over external helicities
+    std::vector<std::array<int,2>> top_hels = get_helicity_pairs(_kinematics->_helicities, 0, 2);
+
+    std::complex<double> L[4][4] = {};
+    for (int n = 0; n < top_hels.size(); n++)
+    {
+        std::complex<double> T[4];
+        for (int mu = 0; mu < 4; mu++)
+        {
+            T[mu] = top_vertex<std::complex<double>>(mu, top_hels[n][0], top_hels[n][1], {_gGam, _gV, _gT});
+        }
+
+        for (int mu = 0; mu < 4; mu++)
+        {
+            for (int rho = 0; rho < 4; rho++)
+            {
+                L[mu][rho] += T[mu] * conj(T[rho]);
+            }
+        }
+    }
+
+    // Bottom tensor from traces 
+    dirac_matrix P_target = _kinematics->_target->projector(_s, PI);          // theta_targ = pi
+    dirac_matrix P_recoil = _kinematics->_recoil->projector(_s, _theta + PI); // theta_rec = theta + pi
+
+    dirac_matrix Gamma[4], Gamma_bar[4];
+    for (int mu = 0; mu < 4; mu++)
+    {
+        Gamma[mu]     = bottom_vertex_matrix(mu);
+        Gamma_bar[mu] = dirac_bar(Gamma[mu]);
+    }
+
+    // Propagator with lowered indices times the bottom tensor
+    std::complex<double> D[4][4], DW[4][4];
+    for (int mu = 0; mu < 4; mu++)
+    {
+        for (int nu = 0; nu < 4; nu++)
+        {
+            D[mu][nu] = METRIC[mu] * vector_propagator(mu, nu) * METRIC[nu];
+        }
+    }
+
+    for (int mu = 0; mu < 4; mu++)
+    {
+        for (int sig = 0; sig < 4; sig++)
+        {
+            DW[mu][sig] = 0.;
+            for (int nu = 0; nu < 4; nu++)
+            {
+                DW[mu][sig] += D[mu][nu] * dirac_trace(Gamma[nu], P_target, Gamma_bar[sig], P_recoil);
+            }
+        }
+    }
+
+    // Contract everything
+    std::complex<double> result = 0.;
+    for (int mu = 0; mu < 4; mu++)
+    {
+        for (int rho = 0; rho < 4; rho++)
+        {
+            std::complex<double> temp = 0.;
+            for (int sig = 0; sig < 4; sig++)
+            {
+                temp += DW[mu][sig] * conj(D[rho][sig]);
+            }
+
+            result += L[mu][rho] * temp;
+        }
+    }
+
+    return real(result) * pow(form_factor(), 2.);
+};
+
+// ---------------------------------------------------------------------------
+// Nucleon - Nucleon - Vector vertex as a matrix in spinor space
+jpacPhoto::dirac_matrix jpacPhoto::vector_exchange::bottom_vertex_matrix(int mu)
+{
+    dirac_matrix result;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            // Vector coupling piece
+            result[i][j] = _gV * GAMMA[mu][i][j];
+
+            // Tensor coupling piece
+            if (abs(_gT) > 0.001)
+            {
+                std::complex<double> sigma_q_ij = 0.;
+                for (int nu = 0; nu < 4; nu++)
+                {
+                    sigma_q_ij += sigma(mu, nu, i, j) * METRIC[nu] * _kinematics->t_exchange_momentum(nu, _s, _theta) / (2. * M_PROTON);
+                }
+
+                result[i][j] -= _gT * sigma_q_ij;
+            }
+        }
+    }
+
+    return result;
+};
\ No newline at end of file
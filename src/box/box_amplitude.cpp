@@ -17,20 +17,206 @@ std::complex<double> jpacPhoto::box_amplitude::helicity_amplitude(std::array<int
     // Pass external values to the discontinuity
     _disc->set_externals(helicities, _theta);
 
-    double sub =  _disc->eval(s);
-    auto F = [&](double sp)
+    if (_checkpoint != NULL)
     {
-        std::complex<double> result = (_disc->eval(sp) - sub) / (sp - s - IEPS);
+        _key = _fingerprint;
+        for (int h : helicities) _key.push_back(h);
+        _key.push_back(_theta);
+
+        // Amplitudes already saved need no dispersion integral at all
+        double re, im;
+        if (_checkpoint->find(amplitude_key(s, 0), re) && _checkpoint->find(amplitude_key(s, 1), im))
+        {
+            return std::complex<double>(re, im);
+        }
+    }
+
+    double sub;
+    if (_checkpoint == NULL || !_checkpoint->find(key(s), sub))
+    {
+        sub = _disc->eval(s);
+        if (_checkpoint != NULL) _checkpoint->save(key(s), sub);
+    }
+
+    // Integrand of the dispersion relation given the discontinuity at sp
+    auto F = [&](double sp, double disc)
+    {
+        std::complex<double> result = (disc - sub) / (sp - s - IEPS);
         return result;
     };
 
-    std::complex<double> intpiece = boost::math::quadrature::gauss_kronrod<double, 15>::integrate(F, _disc->_threshold + EPS, _s_cut, 0, 1.E-6, NULL);
+    // The integral is done as by boost::math::quadrature::gauss_kronrod<double, 15>::integrate but the tree of intervals
+    // is built level by level so the discontinuity at all new nodes of a level may be evaluated in parallel.
+    // Whether an interval is bisected only depends on the interval itself, so the tree and the result are the same as
+    // Boost's recursion and do not depend on the number of threads.
+    // Nodes of different intervals never coincide so every node is a new evaluation of the discontinuity.
+    typedef boost::math::quadrature::gauss_kronrod<double, 15> kronrod;
+    typedef boost::math::quadrature::gauss<double, 7> gauss;
+    auto & x  = kronrod::abscissa();
+    auto & wk = kronrod::weights();
+    auto & wg = gauss::weights();
+
+    struct interval
+    {
+        double a, b, abs_tol;
+        int depth;
+        std::complex<double> estimate;
+        int left, right;
+    };
+
+    double a = _disc->_threshold + EPS, b = _s_cut;
+    double sign = 1.;
+    if (b < a) { std::swap(a, b); sign = -1.; };
+
+    std::vector<box_discontinuity*> copies;
+
+    std::vector<interval> tree;
+    if (a < b) tree.push_back({a, b, 0., 0, 0., -1, -1});
+
+    std::vector<int> level;
+    if (a < b) level.push_back(0);
+
+    while (!level.empty())
+    {
+        // Nodes of each interval ordered as 0, x[1], -x[1], x[2], -x[2], ...
+        std::vector<double> nodes;
+        for (int i : level)
+        {
+            double mean = (tree[i].b + tree[i].a) / 2, scale = (tree[i].b - tree[i].a) / 2;
+            nodes.push_back(scale * 0. + mean);
+            for (int k = 1; k < x.size(); k++)
+            {
+                nodes.push_back(scale * x[k] + mean);
+                nodes.push_back(scale * (-x[k]) + mean);
+            }
+        }
+        std::vector<double> values = evaluate_nodes(nodes, copies);
+
+        std::vector<int> next;
+        for (int l = 0; l < level.size(); l++)
+        {
+            int i = level[l];
+            int first = l * (2 * x.size() - 1);
+            auto ff = [&](int n){ return F(nodes[first + n], values[first + n]); };
+
+            // 7-point Gauss nodes are the even Kronrod nodes
+            std::complex<double> fp, fm;
+            fp = ff(0);
+            std::complex<double> kronrod_result = fp * wk[0];
+            std::complex<double> gauss_result   = 0.;
+            gauss_result += fp * wg[0];
+            for (int k = 2; k < x.size(); k += 2)
+            {
+                fp = ff(2*k - 1); fm = ff(2*k);
+                kronrod_result += (fp + fm) * wk[k];
+                gauss_result   += (fp + fm) * wg[k / 2];
+            }
+            for (int k = 1; k < x.size(); k += 2)
+            {
+                fp = ff(2*k - 1); fm = ff(2*k);
+                kronrod_result += (fp + fm) * wk[k];
+            }
+            double error = std::max(std::abs(kronrod_result - gauss_result), std::abs(kronrod_result * std::numeric_limits<double>::epsilon() * 2.));
+            double scale = (tree[i].b - tree[i].a) / 2;
+
+            tree[i].estimate = scale * kronrod_result;
+
+            double abs_tol1 = std::abs(tree[i].estimate * _tolerance);
+            if (tree[i].abs_tol == 0) tree[i].abs_tol = abs_tol1;
+
+            if (tree[i].depth < _maxDepth && abs_tol1 < error && tree[i].abs_tol < error)
+            {
+                double mid = (tree[i].a + tree[i].b) / 2, abs_tol = tree[i].abs_tol / 2;
+                int depth = tree[i].depth + 1;
+
+                tree[i].left  = tree.size();
+                tree.push_back({tree[i].a, mid, abs_tol, depth, 0., -1, -1});
+                tree[i].right = tree.size();
+                tree.push_back({mid, tree[i].b, abs_tol, depth, 0., -1, -1});
+
+                next.push_back(tree[i].left);
+                next.push_back(tree[i].right);
+            }
+        }
+
+        level = next;
+    }
+
+    for (int i = 0; i < copies.size(); i++) delete copies[i];
+
+    // Sum the leaves in the same order as the recursion
+    std::function<std::complex<double>(int)> sum = [&](int i)
+    {
+        if (tree[i].left < 0) return tree[i].estimate;
+
+        std::complex<double> result = sum(tree[i].left);
+        result += sum(tree[i].right);
+        return result;
+    };
+
+    std::complex<double> intpiece = (tree.empty()) ? 0. : sign * sum(0);
     std::complex<double> logpiece = sub * (log(_s_cut - s - IEPS) - log(_disc->_threshold + EPS - s - IEPS));
     std::complex<double> result =  (intpiece + logpiece) / M_PI;
 
+    if (_checkpoint != NULL)
+    {
+        _checkpoint->save(amplitude_key(s, 0), real(result));
+        _checkpoint->save(amplitude_key(s, 1), imag(result));
+    }
+
     return result;
 };
 
+// ---------------------------------------------------------------------------
+// Nodes not in the checkpoint are evaluated in parallel on copies of the discontinuity.
+// The first is always evaluated by the original, so anything it learns (e.g. the VEGAS grid) is shared by the copies
+std::vector<double> jpacPhoto::box_amplitude::evaluate_nodes(std::vector<double> nodes, std::vector<box_discontinuity*> & copies)
+{
+    std::vector<double> values(nodes.size(), 0.);
+
+    std::vector<int> missing;
+    for (int i = 0; i < nodes.size(); i++)
+    {
+        if (_checkpoint != NULL && _checkpoint->find(key(nodes[i]), values[i])) continue;
+        missing.push_back(i);
+    }
+
+    int start = 0;
+    if (copies.empty() && !missing.empty())
+    {
+        values[missing[0]] = _disc->eval(nodes[missing[0]]);
+        if (_checkpoint != NULL) _checkpoint->save(key(nodes[missing[0]]), values[missing[0]]);
+        start = 1;
+
+        for (int i = 0; i < _nThreads && _nThreads > 1 && missing.size() > 1; i++)
+        {
+            box_discontinuity * copy = _disc->clone();
+            if (copy == NULL) break;
+            copies.push_back(copy);
+        }
+    }
+
+    if (copies.empty())
+    {
+        for (int i = start; i < missing.size(); i++)
+        {
+            values[missing[i]] = _disc->eval(nodes[missing[i]]);
+            if (_checkpoint != NULL) _checkpoint->save(key(nodes[missing[i]]), values[missing[i]]);
+        }
+    }
+    else
+    {
+        parallel_for(missing.size() - start, copies.size(), [&](int i, int thread)
+        {
+            int n = missing[start + i];
+            values[n] = copies[thread]->eval(nodes[n]);
+            if (_checkpoint != NULL) _checkpoint->save(key(nodes[n]), values[n]);
+        });
+    }
+
+    return values;
+};
+
 // ---------------------------------------------------------------------------
 // Override the usual integrated_xsection to use a gauss-legendre integrator since t behavior is smooth but extremely slow
 double jpacPhoto::box_amplitude::integrated_xsection(double s)
@@ -9,59 +9,174 @@
 #include "box/box_discontinuity.hpp"
 
 // ---------------------------------------------------------------------------
-// Evaluate the product of sub-amplitudes integrating over intermediate phase-space
-double jpacPhoto::box_discontinuity::eval(double s)
+// Product of sub-amplitudes at a point in the intermediate phase-space
+// (without the jacobian sin(theta_gam))
+double jpacPhoto::box_discontinuity::integrand(amplitude * left_amp, amplitude * right_amp, double s, double cos_gam, double phi_gam)
 {
-    // Check the intermediate state matched
-    if (_matchError) return 0.;
-
-    // if below threshold return 0
-    if (s < _initialAmp->_kinematics->sth()) return 0.;
-    
     // make sure the external helicites get passed correctly
     int lam_gam = _external_helicities[0];
     int lam_tar = _external_helicities[1];
     int lam_vec = _external_helicities[2];
     int lam_rec = _external_helicities[3];
-    
-    auto dF = [&](const double * x)
+
+    // calculate the sub-process momentum transfers
+    double theta_gam    = TMath::ACos(cos_gam);
+    double t_gam        = left_amp->_kinematics->t_man(s, theta_gam);
+
+    double sin_gam      = sqrt(std::max(0., 1. - cos_gam*cos_gam));
+    double costheta_vec = cos(_external_theta) * cos_gam + sin(_external_theta) * sin_gam * cos(phi_gam);
+    double theta_vec    = TMath::ACos(costheta_vec);
+    double t_vec        = right_amp->_kinematics->t_man(s, theta_vec);
+
+    // Sum over intermediate helicities 
+    std::complex<double> result = 0.;
+    for (int i = 0; i < 4*_jp_left[0]+2; i++)
     {
-        double theta_gam = x[0];
-        double phi_gam   = x[1];
-            
-        // calculate the sub-process momentum transfers
-        double t_gam        = _initialAmp->_kinematics->t_man(s, theta_gam);
-    
-        double costheta_vec = cos(_external_theta) * cos(theta_gam) + sin(_external_theta) * sin(theta_gam) * cos(phi_gam);
-        double theta_vec    = TMath::ACos(costheta_vec);
-        double t_vec        = _finalAmp->_kinematics->t_man(s, theta_vec);
-
-        // Sum over intermediate helicities 
-        std::complex<double> result = 0.;
-        for (int i = 0; i < 4*_jp_left[0]+2; i++)
-        {
-            int lam_meson  = _intermediate_helicities[i][2];
-            int lam_baryon = _intermediate_helicities[i][3];
+        int lam_meson  = _intermediate_helicities[i][2];
+        int lam_baryon = _intermediate_helicities[i][3];
 
-            std::complex<double> left, right;
-            left  = _initialAmp->helicity_amplitude({lam_gam, lam_tar, lam_meson, lam_baryon}, s, t_gam);
-            right = _finalAmp->helicity_amplitude(  {lam_vec, lam_rec, lam_meson, lam_baryon}, s, t_vec);
-            result += left * right;
-        };
+        std::complex<double> left, right;
+        left  = left_amp->helicity_amplitude( {lam_gam, lam_tar, lam_meson, lam_baryon}, s, t_gam);
+        right = right_amp->helicity_amplitude({lam_vec, lam_rec, lam_meson, lam_baryon}, s, t_vec);
+        result += left * right;
+    };
+
+    return real(result);
+};
 
-        double jacobian = sin(theta_gam);
-        return jacobian * real(result);
+// ---------------------------------------------------------------------------
+jpacPhoto::box_discontinuity * jpacPhoto::box_discontinuity::clone()
+{
+    amplitude * left  = _initialAmp->clone();
+    amplitude * right = _finalAmp->clone();
+    if (left == NULL || right == NULL)
+    {
+        delete left; delete right;
+        return NULL;
     };
 
+    box_discontinuity * copy = new box_discontinuity(*this);
+    copy->_initialAmp = left;
+    copy->_finalAmp   = right;
+    copy->_ownsAmps   = true;
+    copy->_nThreads   = 1;
+
+    return copy;
+};
+
+// ---------------------------------------------------------------------------
+// Combined with the same multiply and xor steps as FNV-1a
+uint64_t jpacPhoto::box_discontinuity::fingerprint()
+{
+    std::vector<uint64_t> x = {model_fingerprint(_initialAmp), model_fingerprint(_finalAmp), uint64_t(_method)};
+    if (_method == BOX_INTEGRATOR::VEGAS) x.push_back(_nCalls);
+    if (_method == BOX_INTEGRATOR::GAUSS_LEGENDRE || _method == BOX_INTEGRATOR::SOBOL) x.push_back(_nNodes);
+
+    uint64_t h = 14695981039346656037ULL;
+    for (int i = 0; i < x.size(); i++)
+    {
+        h ^= x[i];
+        h *= 1099511628211ULL;
+    }
+
+    return h;
+};
+
+// ---------------------------------------------------------------------------
+// Nodes and weights of the fixed rules, including the factor 2 from phi in [pi, 2pi]
+void jpacPhoto::box_discontinuity::make_nodes()
+{
+    _nodes.clear();
+
+    if (_method == BOX_INTEGRATOR::SOBOL)
+    {
+        std::vector<std::array<double,2>> x = sobol_2d((_nNodes > 0) ? _nNodes : 1024);
+        for (int i = 0; i < x.size(); i++)
+        {
+            _nodes.push_back({2. * x[i][0] - 1., PI * x[i][1], 4. * PI / double(x.size())});
+        }
+        return;
+    }
+
+    // Otherwise GAUSS_LEGENDRE with the midpoints in phi
+    int n = (_nNodes > 0) ? _nNodes : 16;
+    std::vector<double> x, w;
+    gauss_legendre(n, x, w);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            _nodes.push_back({x[i], PI * (j + 0.5) / double(n), 2. * PI * w[i] / double(n)});
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Evaluate the product of sub-amplitudes integrating over intermediate phase-space
+double jpacPhoto::box_discontinuity::eval(double s)
+{
+    // Check the intermediate state matched
+    if (_matchError) return 0.;
+
+    // if below threshold return 0
+    if (s < _initialAmp->_kinematics->sth()) return 0.;
+
     // Integrate over theta_gamma = [0, pi] and phi = [0, 2pi]
     double min[2] = {0., 0.};
     double max[2] = {PI, 2.*PI};
-    
-    ROOT::Math::IntegratorMultiDim ig(ROOT::Math::IntegrationMultiDim::kDEFAULT);
-    ROOT::Math::Functor wF(dF, 2);
-    ig.SetFunction(wF, 2);
 
-    double result = ig.Integral(min, max);
+    double result;
+    if (_method == BOX_INTEGRATOR::GAUSS_LEGENDRE || _method == BOX_INTEGRATOR::SOBOL)
+    {
+        if (_nodes.empty()) make_nodes();
+
+        amplitude_clones lefts(_initialAmp, _nThreads), rights(_finalAmp, _nThreads);
+
+        // Partial sums per chunk of nodes so the result does not depend on the number of threads
+        int nChunks = (_nodes.size() + _chunk - 1) / _chunk;
+        std::vector<double> partial(nChunks, 0.);
+
+        parallel_for(nChunks, std::min(lefts.size(), rights.size()), [&](int c, int thread)
+        {
+            int end = std::min(int(_nodes.size()), (c + 1) * _chunk);
+            for (int i = c * _chunk; i < end; i++)
+            {
+                partial[c] += _nodes[i][2] * integrand(lefts[thread], rights[thread], s, _nodes[i][0], _nodes[i][1]);
+            }
+        });
+
+        result = 0.;
+        for (int c = 0; c < nChunks; c++) result += partial[c];
+        _error = 0.;
+    }
+    else if (_method == BOX_INTEGRATOR::VEGAS)
+    {
+        // Copies of the sub-amplitudes for each thread, made here so they always have the current parameters
+        amplitude_clones lefts(_initialAmp, _nThreads), rights(_finalAmp, _nThreads);
+        _vegas.set_threads(std::min(lefts.size(), rights.size()));
+
+        auto dF = [&](const double * x, int thread)
+        {
+            return sin(x[0]) * integrand(lefts[thread], rights[thread], s, cos(x[0]), x[1]);
+        };
+
+        vegas_result integral = _vegas.integrate(dF, {min[0], min[1]}, {max[0], max[1]});
+        result = integral.value;
+        _error = integral.error;
+    }
+    else
+    {
+        auto dF = [&](const double * x)
+        {
+            return sin(x[0]) * integrand(_initialAmp, _finalAmp, s, cos(x[0]), x[1]);
+        };
+
+        ROOT::Math::IntegratorMultiDim ig(ROOT::Math::IntegrationMultiDim::kDEFAULT);
+        ROOT::Math::Functor wF(dF, 2);
+        ig.SetFunction(wF, 2);
+
+        result = ig.Integral(min, max);
+    }
 
     // Muliply by the two-body phase space
     double phase_space;
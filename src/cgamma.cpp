@@ -1,81 +1,136 @@
-
 #include "misc_math.hpp"
+#include <vector>
 
 // ------------------------------------------------
-std::complex<double> jpacPhoto::cgamma(std::complex<double> z,int OPT)
+// Complex Gamma function through the Lanczos approximation (g = 7, n = 9)
+// with the reflection formula for Re z < 1/2.
+// log(Gamma) is assembled first so that large arguments do not overflow before
+// being combined with other factors, e.g. s^alpha in Regge propagators.
+// The imaginary part of log(Gamma) is only defined up to multiples of 2 pi.
+
+namespace jpacPhoto
+{
+  static const double LANCZOS_G = 7.;
+  static const double LANCZOS_C[9] = {
+    0.99999999999980993,
+    676.5203681218851,
+    -1259.1392167224028,
+    771.32342877765313,
+    -176.61502916214059,
+    12.507343278686905,
+    -0.13857109526572012,
+    9.9843695780195716e-6,
+    1.5056327351493116e-7};
+};
+
+// ------------------------------------------------
+std::complex<double> jpacPhoto::cgamma(std::complex<double> z, int OPT)
 // OPT = 0 for Gamma ; OPT = 1 for log(Gamma)
 {
-  std::complex<double> I(0,1);
-  std::complex<double> g, infini= 1e308+ 0.*I; // z0,z1
-  double x0,q1,q2,x,y,th,th1,th2,g0,gr,gi,gr1,gi1;
-  double na,t,x1,y1,sr,si;
-  int j,k;
-  x1=9e9;
-  na=9e9;
-
-  static double a[] = {
-    8.333333333333333e-02,
-    -2.777777777777778e-03,
-    7.936507936507937e-04,
-    -5.952380952380952e-04,
-    8.417508417508418e-04,
-    -1.917526917526918e-03,
-    6.410256410256410e-03,
-    -2.955065359477124e-02,
-    1.796443723688307e-01,
-    -1.39243221690590};
-
-  x = real(z); x1 = x;
-  y = imag(z); y1 = y;
-  if (x > 171) return infini;
-  if ((y == 0.0) && (x == (int)x) && (x <= 0.0))
-    return infini;
-  else if (x < 0.0) {
-    x = -x;
-    y = -y;
+  std::complex<double> infini = 1e308;
+  double re = real(z), im = imag(z);
+
+  // Poles at non-positive integers
+  if (im == 0. && re <= 0. && re == floor(re)) return infini;
+
+  // Same steps as the array version below for a single argument
+  bool reflect = (re < 0.5);
+  double x = reflect ? 1. - re : re;
+  double y = reflect ? - im : im;
+
+  double sr = LANCZOS_C[0], si = 0.;
+  for (int k = 1; k < 9; k++)
+  {
+    double dr = x - 1. + k;
+    double d2 = dr*dr + y*y;
+    sr += LANCZOS_C[k] * dr / d2;
+    si -= LANCZOS_C[k] * y / d2;
+  }
+
+  double tr = x + LANCZOS_G - 0.5, ti = y;
+  double lr = 0.5 * log(tr*tr + ti*ti), li = atan2(ti, tr);
+  double gr = 0.5 * log(2.*M_PI) + (x - 0.5) * lr - y * li - tr + 0.5 * log(sr*sr + si*si);
+  double gi = (x - 0.5) * li + y * lr - ti + atan2(si, sr);
+
+  if (reflect)
+  {
+    double snr = sin(M_PI*re) * cosh(M_PI*im);
+    double sni = cos(M_PI*re) * sinh(M_PI*im);
+    gr = log(M_PI) - 0.5 * log(snr*snr + sni*sni) - gr;
+    gi = - atan2(sni, snr) - gi;
   }
-  x0 = x;
-  if (x <= 7.0) {
-    na = (int)(7.0-x);
-    x0 = x+na;
+
+  // Overflow of Gamma itself
+  if (OPT == 0 && gr > 709.) return infini;
+
+  return (OPT == 0) ? std::polar(exp(gr), gi) : std::complex<double>(gr, gi);
+}
+
+// ------------------------------------------------
+// Array version, arguments are split into real and imaginary parts
+// and each step is a flat loop over all arguments so it can be vectorized
+void jpacPhoto::cgamma(const std::complex<double> * z, std::complex<double> * result, int n, int OPT)
+{
+  std::complex<double> infini = 1e308;
+  std::vector<double> x(n), y(n), sr(n), si(n), gr(n), gi(n);
+  std::vector<int> reflect(n);
+
+  // Reflect into the right half plane
+  for (int i = 0; i < n; i++)
+  {
+    double re = real(z[i]), im = imag(z[i]);
+    reflect[i] = (re < 0.5);
+    x[i] = reflect[i] ? 1. - re : re;
+    y[i] = reflect[i] ? - im : im;
   }
-  q1 = sqrt(x0*x0+y*y);
-  th = atan(y/x0);
-  gr = (x0-0.5)*log(q1)-th*y-x0+0.5*log(2.0*M_PI);
-  gi = th*(x0-0.5)+y*log(q1)-y;
-  for (k=0;k<10;k++){
-    t = pow(q1,-1.0-2.0*k);
-    gr += (a[k]*t*cos((2.0*k+1.0)*th));
-    gi -= (a[k]*t*sin((2.0*k+1.0)*th));
+
+  // Lanczos series sum_k c_k / (z - 1 + k)
+  for (int i = 0; i < n; i++)
+  {
+    sr[i] = LANCZOS_C[0]; si[i] = 0.;
   }
-  if (x <= 7.0) {
-    gr1 = 0.0;
-    gi1 = 0.0;
-    for (j=0;j<na;j++) {
-      gr1 += (0.5*log((x+j)*(x+j)+y*y));
-      gi1 += atan(y/(x+j));
+  for (int k = 1; k < 9; k++)
+  {
+    for (int i = 0; i < n; i++)
+    {
+      double dr = x[i] - 1. + k;
+      double d2 = dr*dr + y[i]*y[i];
+      sr[i] += LANCZOS_C[k] * dr / d2;
+      si[i] -= LANCZOS_C[k] * y[i] / d2;
     }
-    gr -= gr1;
-    gi -= gi1;
   }
-  if (x1 <= 0.0) {
-    q1 = sqrt(x*x+y*y);
-    th1 = atan(y/x);
-    sr = -sin(M_PI*x)*cosh(M_PI*y);
-    si = -cos(M_PI*x)*sinh(M_PI*y);
-    q2 = sqrt(sr*sr+si*si);
-    th2 = atan(si/sr);
-    if (sr < 0.0) th2 += M_PI;
-    gr = log(M_PI/(q1*q2))-gr;
-    gi = -th1-th2-gi;
-    x = x1;
-    y = y1;
+
+  // log Gamma(z) = log(2 pi)/2 + (z - 1/2) log(t) - t + log(series), t = z + g - 1/2
+  for (int i = 0; i < n; i++)
+  {
+    double tr = x[i] + LANCZOS_G - 0.5, ti = y[i];
+    double lr = 0.5 * log(tr*tr + ti*ti), li = atan2(ti, tr);
+    gr[i] = 0.5 * log(2.*M_PI) + (x[i] - 0.5) * lr - y[i] * li - tr + 0.5 * log(sr[i]*sr[i] + si[i]*si[i]);
+    gi[i] = (x[i] - 0.5) * li + y[i] * lr - ti + atan2(si[i], sr[i]);
   }
-  if (OPT == 0) {
-    g0 = exp(gr);
-    gr = g0*cos(gi);
-    gi = g0*sin(gi);
+
+  // log Gamma(z) = log(pi) - log(sin(pi z)) - log Gamma(1 - z)
+  for (int i = 0; i < n; i++)
+  {
+    if (!reflect[i]) continue;
+
+    double re = real(z[i]), im = imag(z[i]);
+    double snr = sin(M_PI*re) * cosh(M_PI*im);
+    double sni = cos(M_PI*re) * sinh(M_PI*im);
+    gr[i] = log(M_PI) - 0.5 * log(snr*snr + sni*sni) - gr[i];
+    gi[i] = - atan2(sni, snr) - gi[i];
+  }
+
+  for (int i = 0; i < n; i++)
+  {
+    // Poles at non-positive integers and overflow of Gamma itself
+    bool pole = (imag(z[i]) == 0. && real(z[i]) <= 0. && real(z[i]) == floor(real(z[i])));
+    if (pole || (OPT == 0 && gr[i] > 709.))
+    {
+      result[i] = infini;
+      continue;
+    }
+
+    result[i] = (OPT == 0) ? std::polar(exp(gr[i]), gi[i]) : std::complex<double>(gr[i], gi[i]);
   }
-  g = gr + I*gi;
-  return g;
 }
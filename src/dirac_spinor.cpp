@@ -63,3 +63,29 @@ std::complex<double> jpacPhoto::dirac_spinor::adjoint_component(int i, int lambd
 
     return phase * component(i, lambda, s, theta);
 };
+
+
+// ---------------------------------------------------------------------------
+// Spin projector sum_lambda u_i ubar_j
+jpacPhoto::dirac_matrix jpacPhoto::dirac_spinor::projector(double s, double theta)
+{
+    std::complex<double> u[2][4], ubar[2][4];
+    for (int k = 0; k < 4; k++)
+    {
+        u[0][k]    = component(k, +1, s, theta);
+        u[1][k]    = component(k, -1, s, theta);
+        ubar[0][k] = adjoint_component(k, +1, s, theta);
+        ubar[1][k] = adjoint_component(k, -1, s, theta);
+    }
+
+    dirac_matrix result;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            result[i][j] = u[0][i] * ubar[0][j] + u[1][i] * ubar[1][j];
+        }
+    }
+
+    return result;
+};
\ No newline at end of file
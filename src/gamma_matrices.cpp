@@ -35,3 +35,62 @@ double jpacPhoto::levi_civita(int a, int b, int c, int d)
 
     return result;
 };
+
+
+// ---------------------------------------------------------------------------
+// Matrix product A.B
+jpacPhoto::dirac_matrix jpacPhoto::dirac_product(const dirac_matrix & A, const dirac_matrix & B)
+{
+    dirac_matrix result;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            result[i][j] = 0.;
+            for (int k = 0; k < 4; k++)
+            {
+                result[i][j] += A[i][k] * B[k][j];
+            }
+        }
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Dirac conjugate gamma_0 A^dagger gamma_0
+// gamma_0 is diagonal so this only flips the sign of the off-diagonal blocks
+jpacPhoto::dirac_matrix jpacPhoto::dirac_bar(const dirac_matrix & A)
+{
+    dirac_matrix result;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            result[i][j] = real(GAMMA[0][i][i] * GAMMA[0][j][j]) * conj(A[j][i]);
+        }
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Traces of products
+std::complex<double> jpacPhoto::dirac_trace(const dirac_matrix & A, const dirac_matrix & B)
+{
+    std::complex<double> result = 0.;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            result += A[i][k] * B[k][i];
+        }
+    }
+
+    return result;
+};
+
+std::complex<double> jpacPhoto::dirac_trace(const dirac_matrix & A, const dirac_matrix & B, const dirac_matrix & C, const dirac_matrix & D)
+{
+    return dirac_trace(dirac_product(A, B), dirac_product(C, D));
+};
\ No newline at end of file
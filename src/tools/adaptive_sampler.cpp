@@ -0,0 +1,133 @@
+// Adaptive sampling of one-dimensional curves, e.g. observables as functions of energy
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/adaptive_sampler.hpp"
+
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <queue>
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::adaptive_sampler::add_pole(double mass, double width)
+{
+    _poles.push_back({mass, width});
+};
+
+void jpacPhoto::adaptive_sampler::add_threshold(double x)
+{
+    _thresholds.push_back(x);
+};
+
+void jpacPhoto::adaptive_sampler::add_structures(amplitude * amp)
+{
+    std::vector<std::array<double, 2>> poles = amp->resonances();
+    for (int i = 0; i < poles.size(); i++) add_pole(poles[i][0], poles[i][1]);
+
+    add_threshold(amp->_kinematics->Wth());
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::adaptive_sampler::add_point(double x)
+{
+    if (_points.count(x) == 0) _points[x] = _F(x);
+};
+
+// ---------------------------------------------------------------------------
+std::array<std::vector<double>, 2> jpacPhoto::adaptive_sampler::sample(double xmin, double xmax, int N, bool PRINT)
+{
+    _points.clear();
+
+    // Initial uniform grid, which needs at least both end points
+    if (N < 2) N = 2;
+    for (int i = 0; i < N; i++)
+    {
+        add_point(xmin + double(i) * (xmax - xmin) / double(N - 1));
+    }
+
+    // Points around poles at fractions of the width on either side
+    double offsets[] = {0., 0.25, 0.5, 1., 2., 4.};
+    for (int i = 0; i < _poles.size(); i++)
+    {
+        for (int j = 0; j < 6; j++)
+        {
+            double x_plus  = _poles[i][0] + offsets[j] * _poles[i][1];
+            double x_minus = _poles[i][0] - offsets[j] * _poles[i][1];
+            if (x_plus  >= xmin && x_plus  <= xmax) add_point(x_plus);
+            if (x_minus >= xmin && x_minus <= xmax) add_point(x_minus);
+        }
+    }
+
+    // Thresholds (just above to stay in the physical region)
+    for (int i = 0; i < _thresholds.size(); i++)
+    {
+        double x = _thresholds[i] + EPS;
+        if (x >= xmin && x <= xmax) add_point(x);
+    }
+
+    // Scale to compare interpolation errors to
+    double fmin = _points.begin()->second, fmax = fmin;
+    for (auto it = _points.begin(); it != _points.end(); ++it)
+    {
+        fmin = std::min(fmin, it->second);
+        fmax = std::max(fmax, it->second);
+    }
+    double scale = (fmax - fmin > 0.) ? (fmax - fmin) : std::max(std::abs(fmax), 1.);
+
+    // Intervals still to check, largest interpolation error of the parent interval first
+    // so the point budget goes where the curve is worst resolved.
+    // Intervals of the initial grid have not been checked yet and come before all others
+    typedef std::pair<double, std::array<double, 2>> interval;
+    std::priority_queue<interval> intervals;
+    for (auto it = _points.begin(); std::next(it) != _points.end(); ++it)
+    {
+        intervals.push({std::numeric_limits<double>::infinity(), {it->first, std::next(it)->first}});
+    }
+
+    double min_width = 1.E-9 * (xmax - xmin);
+    while (!intervals.empty() && _points.size() < _maxPoints)
+    {
+        std::array<double, 2> ab = intervals.top().second;
+        intervals.pop();
+
+        double a = ab[0], b = ab[1];
+        if (b - a < min_width) continue;
+
+        double m = (a + b) / 2.;
+        add_point(m);
+
+        double linear = (_points[a] + _points[b]) / 2.;
+
+        // Update the scale if the curve extends beyond what has been seen so far
+        fmin = std::min(fmin, _points[m]);
+        fmax = std::max(fmax, _points[m]);
+        if (fmax - fmin > scale) scale = fmax - fmin;
+
+        double error = std::abs(_points[m] - linear);
+        if (error > _tolerance * scale)
+        {
+            intervals.push({error, {a, m}});
+            intervals.push({error, {m, b}});
+        }
+    }
+
+    if (!intervals.empty())
+    {
+        std::cout << "adaptive_sampler: Maximum number of points (" << _maxPoints << ") reached before tolerance was met! \n";
+    }
+
+    std::vector<double> x, fx;
+    for (auto it = _points.begin(); it != _points.end(); ++it)
+    {
+        x.push_back(it->first);
+        fx.push_back(it->second);
+
+        if (PRINT) std::cout << std::left << std::setw(15) << it->first << std::setw(15) << it->second << "\n";
+    }
+
+    return {x, fx};
+};
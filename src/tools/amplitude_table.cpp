@@ -0,0 +1,258 @@
+// Binary tables of helicity amplitudes on a grid which can be memory-mapped by other programs
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/amplitude_table.hpp"
+
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace jpacPhoto
+{
+    static const char AMPLITUDE_TABLE_MAGIC[8] = {'J', 'P', 'A', 'C', 'T', 'A', 'B', '1'};
+    static const uint32_t AMPLITUDE_TABLE_VERSION = 1;
+    static const uint32_t AMPLITUDE_TABLE_ENDIAN  = 0x01020304;
+
+    // Amplitudes start at a multiple of this many bytes
+    static const uint64_t AMPLITUDE_TABLE_ALIGN = 4096;
+
+    // FNV-1a hash of a sequence of bytes, continuing from h
+    inline uint64_t fnv1a(const void * data, size_t n, uint64_t h = 14695981039346656037ULL)
+    {
+        const unsigned char * x = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; i++)
+        {
+            h ^= x[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    };
+};
+
+// ---------------------------------------------------------------------------
+// The reference point is 1 GeV above threshold at 60 degrees
+uint64_t jpacPhoto::model_fingerprint(amplitude * amp)
+{
+    reaction_kinematics * kinem = amp->_kinematics;
+
+    uint64_t h = fnv1a(amp->_identifier.data(), amp->_identifier.size());
+
+    double masses[4] = {kinem->_mB, kinem->_mT, kinem->_mX, kinem->_mR};
+    h = fnv1a(masses, sizeof(masses), h);
+    h = fnv1a(kinem->_jp.data(), 2 * sizeof(int), h);
+
+    double s = pow(kinem->Wth() + 1., 2.);
+    double t = kinem->t_man(s, PI / 3.);
+
+    // Through the cache so amplitudes which vanish (see amplitude::is_nonzero) or follow from parity are not evaluated.
+    // It is emptied first since e.g. a constituent of a sum may have changed without resetting the cache of the sum
+    amp->reset_cache();
+    amp->check_cache(s, t);
+    for (int k = 0; k < kinem->_nAmps; k++)
+    {
+        std::complex<double> A = amp->_cached_helicity_amplitude[k];
+        h = fnv1a(&A, sizeof(A), h);
+    }
+
+    // Also the cross section, which amplitudes without individual helicity amplitudes (e.g. primakoff_effect)
+    // provide directly and otherwise follows from the cached amplitudes
+    double dsigma = amp->differential_xsection(s, t);
+    h = fnv1a(&dsigma, sizeof(dsigma), h);
+
+    return h;
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::amplitude_tabulator::write(std::string filename)
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open())
+    {
+        std::cout << "amplitude_tabulator: Cannot open file " << filename << "!\n";
+        return false;
+    }
+
+    reaction_kinematics * kinem = _amp->_kinematics;
+    int nAmps = kinem->_nAmps;
+
+    table_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, AMPLITUDE_TABLE_MAGIC, 8);
+    header.version     = AMPLITUDE_TABLE_VERSION;
+    header.endian      = AMPLITUDE_TABLE_ENDIAN;
+    header.grid        = uint32_t(_grid);
+    header.nHelicities = nAmps;
+    header.xmin = _x.min; header.xmax = _x.max; header.nx = _x.n;
+    header.ymin = _y.min; header.ymax = _y.max; header.ny = _y.n;
+    header.masses[0] = kinem->_mB; header.masses[1] = kinem->_mT;
+    header.masses[2] = kinem->_mX; header.masses[3] = kinem->_mR;
+    header.jp[0] = kinem->_jp[0];  header.jp[1] = kinem->_jp[1];
+    header.fingerprint = model_fingerprint(_amp);
+    std::strncpy(header.identifier, _amp->_identifier.c_str(), sizeof(header.identifier) - 1);
+
+    uint64_t header_size = sizeof(table_header) + nAmps * 4 * sizeof(int32_t);
+    header.data_offset = ((header_size + AMPLITUDE_TABLE_ALIGN - 1) / AMPLITUDE_TABLE_ALIGN) * AMPLITUDE_TABLE_ALIGN;
+    header.data_size   = uint64_t(_x.n) * _y.n * nAmps * sizeof(std::complex<double>);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int k = 0; k < nAmps; k++)
+    {
+        int32_t h[4] = {kinem->_helicities[k][0], kinem->_helicities[k][1], kinem->_helicities[k][2], kinem->_helicities[k][3]};
+        out.write(reinterpret_cast<const char*>(h), sizeof(h));
+    }
+    std::vector<char> padding(header.data_offset - header_size, 0);
+    out.write(padding.data(), padding.size());
+
+    // Evaluate blocks of rows in parallel and write them in order
+    amplitude_clones amps(_amp, _nThreads);
+    double nan = std::numeric_limits<double>::quiet_NaN();
+
+    for (int start = 0; start < _x.n; start += _block)
+    {
+        int nRows = std::min(_block, _x.n - start);
+        std::vector<std::complex<double>> rows(uint64_t(nRows) * _y.n * nAmps);
+
+        parallel_for(nRows, amps.size(), [&](int r, int thread)
+        {
+            amplitude * amp = amps[thread];
+            double x = _x.node(start + r);
+
+            double s = (_grid == TABLE_GRID::S_T) ? x : kinem->s_from_Egam(x);
+            bool physical = (s > kinem->sth());
+
+            for (int j = 0; j < _y.n; j++)
+            {
+                std::complex<double> * row = &rows[(uint64_t(r) * _y.n + j) * nAmps];
+                double y = _y.node(j);
+
+                double t = 0.;
+                bool inside = physical;
+                if (physical && _grid == TABLE_GRID::S_T)
+                {
+                    t = y;
+                    inside = (t <= kinem->t_man(s, 0.) && t >= kinem->t_man(s, PI));
+                }
+                else if (physical)
+                {
+                    inside = (std::abs(y) <= 1.);
+                    if (inside) t = kinem->t_man(s, acos(y));
+                }
+
+                if (!inside)
+                {
+                    for (int k = 0; k < nAmps; k++) row[k] = std::complex<double>(nan, nan);
+                    continue;
+                }
+
+                amp->check_cache(s, t);
+                for (int k = 0; k < nAmps; k++) row[k] = amp->_cached_helicity_amplitude[k];
+            }
+        });
+
+        out.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(std::complex<double>));
+    }
+
+    return out.good();
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::amplitude_table::amplitude_table(std::string filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cout << "amplitude_table: Cannot open file " << filename << "!\n";
+        return;
+    }
+
+    struct stat info;
+    fstat(fd, &info);
+    size_t size = info.st_size;
+
+    bool valid = (size >= sizeof(table_header)) && (pread(fd, &_header, sizeof(table_header), 0) == sizeof(table_header));
+    valid = valid && std::equal(_header.magic, _header.magic + 8, AMPLITUDE_TABLE_MAGIC);
+    valid = valid && _header.version == AMPLITUDE_TABLE_VERSION && _header.endian == AMPLITUDE_TABLE_ENDIAN;
+    valid = valid && _header.data_offset % AMPLITUDE_TABLE_ALIGN == 0;
+    valid = valid && _header.data_size == _header.nx * _header.ny * _header.nHelicities * sizeof(std::complex<double>);
+    valid = valid && _header.data_offset + _header.data_size <= size;
+
+    if (!valid)
+    {
+        std::cout << "amplitude_table: " << filename << " is not a valid amplitude table!\n";
+        close(fd);
+        return;
+    }
+    _header.identifier[sizeof(_header.identifier) - 1] = '\0';
+
+    void * map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        std::cout << "amplitude_table: Cannot map file " << filename << "!\n";
+        return;
+    }
+
+    _map = map; _mapSize = size;
+    _data = reinterpret_cast<const std::complex<double>*>(static_cast<const char*>(map) + _header.data_offset);
+
+    const int32_t * h = reinterpret_cast<const int32_t*>(static_cast<const char*>(map) + sizeof(table_header));
+    for (int k = 0; k < _header.nHelicities; k++)
+    {
+        _helicities.push_back({h[4*k], h[4*k+1], h[4*k+2], h[4*k+3]});
+    }
+};
+
+jpacPhoto::amplitude_table::~amplitude_table()
+{
+    if (_map != NULL) munmap(_map, _mapSize);
+};
+
+// ---------------------------------------------------------------------------
+int jpacPhoto::amplitude_table::helicity_index(std::array<int, 4> helicities)
+{
+    for (int k = 0; k < _helicities.size(); k++)
+    {
+        if (_helicities[k] == helicities) return k;
+    }
+    return -1;
+};
+
+// ---------------------------------------------------------------------------
+std::complex<double> jpacPhoto::amplitude_table::interpolate(int k, double x, double y)
+{
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    if (!is_open() || k < 0 || k >= _header.nHelicities) return std::complex<double>(nan, nan);
+
+    // Position between nodes along one axis, false if outside
+    auto locate = [](double z, double min, double max, uint64_t n, int & i, double & f)
+    {
+        if (n == 1) { i = 0; f = 0.; return (z == min); };
+        if (z < min || z > max) return false;
+
+        double u = (z - min) / (max - min) * double(n - 1);
+        i = std::min(int(u), int(n) - 2);
+        f = u - i;
+        return true;
+    };
+
+    int i, j;
+    double fx, fy;
+    if (!locate(x, _header.xmin, _header.xmax, _header.nx, i, fx) || !locate(y, _header.ymin, _header.ymax, _header.ny, j, fy))
+    {
+        return std::complex<double>(nan, nan);
+    }
+
+    // Single nodes along an axis are handled by repeating them
+    int i1 = (_header.nx > 1) ? i + 1 : i;
+    int j1 = (_header.ny > 1) ? j + 1 : j;
+
+    return (1. - fx) * (1. - fy) * at(k, i, j)  + (1. - fx) * fy * at(k, i, j1)
+         +       fx  * (1. - fy) * at(k, i1, j) +       fx  * fy * at(k, i1, j1);
+};
@@ -0,0 +1,173 @@
+// Evaluation of observables for many parameter sets at once, e.g. for uncertainty bands
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/batch_evaluator.hpp"
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::batch_evaluator::set_parameter_sets(std::vector<std::vector<double>> params)
+{
+    if (params.size() != _amp->_nParams)
+    {
+        std::cout << "batch_evaluator: Invalid number of parameters (" << params.size() << ") passed for " << _amp->_identifier << "!\n";
+        return;
+    }
+
+    for (int k = 1; k < params.size(); k++)
+    {
+        if (params[k].size() != params[0].size())
+        {
+            std::cout << "batch_evaluator: Parameters have different numbers of sets!\n";
+            return;
+        }
+    }
+
+    _params = params;
+    _nSets  = (params.size() > 0) ? params[0].size() : 0;
+};
+
+std::vector<double> jpacPhoto::batch_evaluator::parameter_set(int n)
+{
+    std::vector<double> result;
+    for (int k = 0; k < _params.size(); k++) result.push_back(_params[k][n]);
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+std::vector<std::vector<double>> jpacPhoto::batch_evaluator::eval(observable F, std::vector<std::array<double, 2>> points)
+{
+    std::vector<std::vector<double>> result(points.size());
+    if (_nSets == 0) return result;
+
+    amplitude_clones amps(_amp, _nThreads);
+    bool factorized = (_amp->n_monomials() > 0);
+
+    // Structures are recombined in the cache so the spin-summed shortcut is not used
+    std::vector<bool> traces;
+    for (int i = 0; i < amps.size(); i++)
+    {
+        traces.push_back(amps[i]->_useTraces);
+        if (factorized) amps[i]->set_traces(false);
+    }
+
+    parallel_for(points.size(), amps.size(), [&](int i, int thread)
+    {
+        double s = points[i][0], t = points[i][1];
+
+        result[i] = (factorized) ? eval_factorized(amps[thread], F, s, t) 
+                                 : eval_direct(amps[thread], F, s, t);
+    });
+
+    // Leave the amplitudes as they were
+    for (int i = 0; i < amps.size(); i++)
+    {
+        amps[i]->set_traces(traces[i]);
+        amps[i]->reset_cache();
+    }
+    _amp->set_params(parameter_set(_nSets - 1));
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+std::vector<double> jpacPhoto::batch_evaluator::eval_direct(amplitude * amp, observable & F, double s, double t)
+{
+    std::vector<double> result(_nSets);
+    for (int n = 0; n < _nSets; n++)
+    {
+        amp->set_params(parameter_set(n));
+        result[n] = F(amp, s, t);
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+std::vector<double> jpacPhoto::batch_evaluator::eval_factorized(amplitude * amp, observable & F, double s, double t)
+{
+    int nAmps = amp->_kinematics->_nAmps;
+    int nM    = amp->n_monomials();
+
+    amp->update_mask();
+    amp->update_parity();
+    int nCalc = (amp->_useParity) ? nAmps/2 : nAmps;
+
+    // Parameter independent structures B[h][m]
+    std::vector<std::vector<std::complex<double>>> B(nCalc);
+    for (int h = 0; h < nCalc; h++)
+    {
+        if (amp->_helicity_mask[h]) B[h] = amp->monomial_amplitudes(amp->_kinematics->_helicities[h], s, t);
+    }
+
+    // Coefficients c[m][n]
+    std::vector<std::vector<std::complex<double>>> c(nM, std::vector<std::complex<double>>(_nSets));
+    for (int n = 0; n < _nSets; n++)
+    {
+        std::vector<std::complex<double>> c_n = amp->coupling_monomials(parameter_set(n), s, t);
+        for (int m = 0; m < nM; m++) c[m][n] = c_n[m];
+    }
+
+    // A[h][n] = sum_m c[m][n] B[h][m] 
+    std::vector<std::vector<std::complex<double>>> A(nCalc, std::vector<std::complex<double>>(_nSets, 0.));
+    for (int h = 0; h < nCalc; h++)
+    {
+        if (!amp->_helicity_mask[h]) continue;
+
+        std::complex<double> * A_h = A[h].data();
+        for (int m = 0; m < nM; m++)
+        {
+            std::complex<double>   B_hm = B[h][m];
+            std::complex<double> * c_m  = c[m].data();
+            for (int n = 0; n < _nSets; n++) A_h[n] += c_m[n] * B_hm;
+        }
+    }
+
+    // Evaluate the observable for each set from the cache
+    std::vector<double> result(_nSets);
+    for (int n = 0; n < _nSets; n++)
+    {
+        amp->set_params(parameter_set(n));
+
+        std::vector<std::complex<double>> A_n(nCalc);
+        for (int h = 0; h < nCalc; h++) A_n[h] = A[h][n];
+        amp->set_cache(s, t, A_n);
+
+        result[n] = F(amp, s, t);
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+std::vector<std::vector<double>> jpacPhoto::batch_evaluator::bands(observable F, std::vector<std::array<double, 2>> points, std::vector<double> percentiles)
+{
+    std::vector<std::vector<double>> values = eval(F, points);
+
+    std::vector<std::vector<double>> result;
+    for (int i = 0; i < values.size(); i++)
+    {
+        std::vector<double> x = values[i];
+        std::sort(x.begin(), x.end());
+
+        // Linear interpolation between order statistics
+        std::vector<double> band;
+        for (int j = 0; j < percentiles.size(); j++)
+        {
+            if (x.size() == 0) { band.push_back(0.); continue; }
+
+            double pos = std::min(std::max(percentiles[j], 0.), 100.) / 100. * double(x.size() - 1);
+            int lo = int(pos);
+            int hi = std::min(lo + 1, int(x.size()) - 1);
+
+            band.push_back(x[lo] + (pos - double(lo)) * (x[hi] - x[lo]));
+        }
+
+        result.push_back(band);
+    }
+
+    return result;
+};
@@ -0,0 +1,154 @@
+// Observables integrated over bins in energy and momentum transfer for comparison with binned data
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/binned_observables.hpp"
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::binned_observables::s_from(double E)
+{
+    if (_evar == ENERGY_VARIABLE::W) return E * E;
+    return _amp->_kinematics->s_from_Egam(E);
+};
+
+// ---------------------------------------------------------------------------
+std::array<std::vector<double>, 2> jpacPhoto::binned_observables::t_nodes(kinematic_bin bin, double s)
+{
+    if (s <= _amp->_kinematics->sth()) return {};
+
+    double lo = std::max(bin.tmin, _amp->_kinematics->t_man(s, PI));
+    double hi = std::min(bin.tmax, _amp->_kinematics->t_man(s, 0.));
+
+    if (lo > hi) return {};
+    if (bin.tmin == bin.tmax) return {std::vector<double>({lo}), std::vector<double>({1.})};
+
+    return gauss_lobatto(_order, lo, hi);
+};
+
+// ---------------------------------------------------------------------------
+std::vector<std::vector<double>> jpacPhoto::binned_observables::eval(std::vector<kinematic_bin> bins, std::vector<observable> obs)
+{
+    // Node index and weight
+    struct node { int i; double w; };
+
+    // Collect the distinct energies needed by all bins
+    std::map<double, int> E_index;
+    std::vector<double> E_values;
+    std::vector<std::vector<node>> E_nodes(bins.size());
+
+    for (int b = 0; b < bins.size(); b++)
+    {
+        std::array<std::vector<double>, 2> xw;
+        if (bins[b].Emin == bins[b].Emax) xw = {std::vector<double>({bins[b].Emin}), std::vector<double>({1.})};
+        else                              xw = gauss_lobatto(_order, bins[b].Emin, bins[b].Emax);
+
+        for (int i = 0; i < xw[0].size(); i++)
+        {
+            auto found = E_index.find(xw[0][i]);
+            if (found == E_index.end())
+            {
+                found = E_index.insert({xw[0][i], E_values.size()}).first;
+                E_values.push_back(xw[0][i]);
+            }
+            E_nodes[b].push_back({found->second, xw[1][i]});
+        }
+    }
+
+    // At each energy collect the distinct values of t needed by all bins containing it
+    // t_nodes[b][j] are the t nodes of bin b at its j-th energy node
+    std::vector<std::map<double, int>> t_index(E_values.size());
+    std::vector<std::vector<double>> t_values(E_values.size());
+    std::vector<std::vector<std::vector<node>>> t_nodes_in_bin(bins.size());
+
+    for (int b = 0; b < bins.size(); b++)
+    {
+        for (int j = 0; j < E_nodes[b].size(); j++)
+        {
+            int iE = E_nodes[b][j].i;
+            std::array<std::vector<double>, 2> xw = t_nodes(bins[b], s_from(E_values[iE]));
+
+            std::vector<node> ts;
+            for (int i = 0; i < xw[0].size(); i++)
+            {
+                auto found = t_index[iE].find(xw[0][i]);
+                if (found == t_index[iE].end())
+                {
+                    found = t_index[iE].insert({xw[0][i], t_values[iE].size()}).first;
+                    t_values[iE].push_back(xw[0][i]);
+                }
+                ts.push_back({found->second, xw[1][i]});
+            }
+            t_nodes_in_bin[b].push_back(ts);
+        }
+    }
+
+    // Evaluate the cross section and observables at every distinct node
+    // values[iE][it] = { dsigma/dt, O_1, O_2, ... }
+    std::vector<std::vector<std::vector<double>>> values(E_values.size());
+
+    amplitude_clones amps(_amp, _nThreads);
+    parallel_for(E_values.size(), amps.size(), [&](int iE, int thread)
+    {
+        amplitude * amp = amps[thread];
+        double s = s_from(E_values[iE]);
+
+        for (int it = 0; it < t_values[iE].size(); it++)
+        {
+            double t = t_values[iE][it];
+
+            std::vector<double> x;
+            x.push_back(amp->differential_xsection(s, t));
+            for (int k = 0; k < obs.size(); k++) x.push_back(obs[k](amp, s, t));
+
+            values[iE].push_back(x);
+        }
+    });
+
+    // Assemble the bins
+    std::vector<std::vector<double>> result;
+    for (int b = 0; b < bins.size(); b++)
+    {
+        double area = 0.;
+        std::vector<double> sums(obs.size() + 1, 0.);
+
+        for (int j = 0; j < E_nodes[b].size(); j++)
+        {
+            int iE = E_nodes[b][j].i;
+            for (int i = 0; i < t_nodes_in_bin[b][j].size(); i++)
+            {
+                node nt = t_nodes_in_bin[b][j][i];
+                double w = E_nodes[b][j].w * nt.w;
+                std::vector<double> & x = values[iE][nt.i];
+
+                area    += w;
+                sums[0] += w * x[0];
+                for (int k = 1; k < x.size(); k++) sums[k] += w * x[0] * x[k];
+            }
+        }
+
+        std::vector<double> averages(obs.size() + 1, 0.);
+        if (area > 0.)   averages[0] = sums[0] / area;
+        if (sums[0] != 0.)
+        {
+            for (int k = 1; k < sums.size(); k++) averages[k] = sums[k] / sums[0];
+        }
+
+        result.push_back(averages);
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+std::vector<double> jpacPhoto::binned_observables::xsections(std::vector<kinematic_bin> bins)
+{
+    std::vector<std::vector<double>> all = eval(bins);
+
+    std::vector<double> result;
+    for (int b = 0; b < all.size(); b++) result.push_back(all[b][0]);
+
+    return result;
+};
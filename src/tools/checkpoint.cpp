@@ -0,0 +1,123 @@
+// Persistent store of expensive intermediate values so interrupted calculations can resume
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/checkpoint.hpp"
+
+#include <iostream>
+#include <unistd.h>
+
+namespace jpacPhoto
+{
+    static const char CHECKPOINT_MAGIC[8] = {'J', 'P', 'A', 'C', 'C', 'K', 'P', '1'};
+
+    // Keys longer than this are taken to be a damaged file
+    static const uint32_t CHECKPOINT_MAX_KEY = 1024;
+};
+
+// ---------------------------------------------------------------------------
+// Each value is saved as { key length, key, value }
+jpacPhoto::checkpoint::checkpoint(std::string filename, int N_flush)
+: _filename(filename), _nFlush(std::max(1, N_flush))
+{
+    // Start a new file with only the header
+    auto start_new = [&]()
+    {
+        std::ofstream out(_filename, std::ios::binary | std::ios::trunc);
+        out.write(CHECKPOINT_MAGIC, 8);
+    };
+
+    std::ifstream in(_filename, std::ios::binary);
+    if (!in.is_open() || in.peek() == EOF) { in.close(); start_new(); return; };
+
+    char magic[8];
+    in.read(magic, 8);
+    if (!in.good() || !std::equal(magic, magic + 8, CHECKPOINT_MAGIC))
+    {
+        std::cout << "checkpoint: " << _filename << " is not a checkpoint file, values will only be kept in memory!\n";
+        _filename.clear();
+        return;
+    }
+
+    long complete = in.tellg();
+    while (true)
+    {
+        uint32_t n;
+        in.read(reinterpret_cast<char*>(&n), sizeof(n));
+        if (!in.good() || n > CHECKPOINT_MAX_KEY) break;
+
+        std::vector<double> key(n);
+        double value;
+        in.read(reinterpret_cast<char*>(key.data()), n * sizeof(double));
+        in.read(reinterpret_cast<char*>(&value), sizeof(double));
+        if (!in.good()) break;
+
+        _values[key] = value;
+        complete = in.tellg();
+    }
+    in.close();
+
+    // Remove a partially written value so new ones are appended after the last complete one
+    if (truncate(_filename.c_str(), complete) != 0)
+    {
+        std::cout << "checkpoint: Cannot write to " << _filename << "!\n";
+    }
+
+    _nRead = _values.size();
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::checkpoint::find(const std::vector<double> & key, double & value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto found = _values.find(key);
+    if (found == _values.end()) return false;
+
+    value = found->second;
+    return true;
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::checkpoint::save(const std::vector<double> & key, double value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_values.insert({key, value}).second) return;
+
+    _new.push_back({key, value});
+    if (_new.size() >= _nFlush) write_new();
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::checkpoint::flush()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    write_new();
+};
+
+void jpacPhoto::checkpoint::write_new()
+{
+    if (_new.empty() || _filename.empty()) return;
+
+    std::ofstream out(_filename, std::ios::binary | std::ios::app);
+    if (!out.is_open())
+    {
+        std::cout << "checkpoint: Cannot write to " << _filename << "!\n";
+        return;
+    }
+
+    for (int i = 0; i < _new.size(); i++)
+    {
+        uint32_t n = _new[i].first.size();
+        out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        out.write(reinterpret_cast<const char*>(_new[i].first.data()), n * sizeof(double));
+        out.write(reinterpret_cast<const char*>(&_new[i].second), sizeof(double));
+    }
+
+    out.flush();
+    _new.clear();
+};
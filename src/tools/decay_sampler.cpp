@@ -0,0 +1,303 @@
+// Decay angles of polarized vector mesons sampled from tabulated spin density matrix elements
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/decay_sampler.hpp"
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::decay_sampler::s_from(double E)
+{
+    if (_evar == ENERGY_VARIABLE::W) return E * E;
+    return _amp->_kinematics->s_from_Egam(E);
+};
+
+double jpacPhoto::decay_sampler::E_from(double s)
+{
+    if (_evar == ENERGY_VARIABLE::W) return sqrt(s);
+    return _amp->_kinematics->Egam_from_s(s);
+};
+
+// ---------------------------------------------------------------------------
+// The helicity frame has z along the meson momentum n in the CoM frame and x = y cross n.
+// The beam boosted to the meson rest frame lies in the x-z plane at an angle omega from n
+double jpacPhoto::decay_sampler::frame_rotation(double s, double t)
+{
+    reaction_kinematics * kinem = _amp->_kinematics;
+    double theta = kinem->theta_s(s, t);
+
+    double EV = real(kinem->_final_state->energy_V(s));
+    double pV = real(kinem->_final_state->momentum(s));
+    double k0 = real(kinem->_initial_state->energy_V(s));
+    double k  = real(kinem->_initial_state->momentum(s));
+
+    double gamma = EV / kinem->_mX, beta = pV / EV;
+
+    // Boosted beam is k + c n 
+    double c = (gamma - 1.) * k * cos(theta) - gamma * beta * k0;
+
+    return atan2(-k * sin(theta), k * cos(theta) + c);
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::decay_sampler::sdme_matrices jpacPhoto::decay_sampler::calculate(amplitude * amp, double s, double t)
+{
+    sdme_matrices rho;
+    rho.fill(0.);
+
+    amp->check_cache(s, t);
+    std::vector<std::complex<double>> & A = amp->_cached_helicity_amplitude;
+
+    double norm = 0.;
+    for (int i = 0; i < A.size(); i++) norm += std::norm(A[i]);
+    if (norm <= 0.) return rho;
+
+    auto index = [&](int lam_gam, int lam_N, int lam, int lam_Np)
+    {
+        return find_helicity({lam_gam, lam_N, lam, lam_Np}, 1, 0.);
+    };
+
+    // Same sums as amplitude::SDME() for every element at once
+    for (int lam_gam : {1, -1})
+    {
+        for (int lam_N : {1, -1})
+        {
+            for (int lam_Np : {1, -1})
+            {
+                for (int lam = -1; lam <= 1; lam++)
+                {
+                    for (int lamp = -1; lamp <= 1; lamp++)
+                    {
+                        std::complex<double> amp_star = conj(A[index(lam_gam, lam_N, lamp, lam_Np)]);
+
+                        double x0 = real(A[index( lam_gam, lam_N, lam, lam_Np)] * amp_star);
+                        double x1 = real(A[index(-lam_gam, lam_N, lam, lam_Np)] * amp_star);
+
+                        int e = 3 * (lam + 1) + (lamp + 1);
+                        rho[e]      += x0;
+                        rho[9 + e]  += x1;
+                        rho[18 + e] += XI * double(lam_gam) * x1;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int e = 0; e < 27; e++) rho[e] /= norm;
+
+    if (_frame == DECAY_FRAME::HELICITY) return rho;
+
+    // Components along the rotated axes, rho -> d(-omega) rho d(-omega)^T
+    double omega = frame_rotation(s, t);
+    double d[3][3];
+    for (int lam = -1; lam <= 1; lam++)
+    {
+        for (int mu = -1; mu <= 1; mu++) d[lam + 1][mu + 1] = wigner_d_int(1, lam, mu, -omega);
+    }
+
+    sdme_matrices rotated;
+    rotated.fill(0.);
+    for (int alpha = 0; alpha < 3; alpha++)
+    {
+        for (int a = 0; a < 3; a++)
+        {
+            for (int b = 0; b < 3; b++)
+            {
+                for (int m = 0; m < 3; m++)
+                {
+                    for (int n = 0; n < 3; n++) rotated[9*alpha + 3*a + b] += d[a][m] * rho[9*alpha + 3*m + n] * d[b][n];
+                }
+            }
+        }
+    }
+
+    return rotated;
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::decay_sampler::initialize()
+{
+    if (_initialized) return true;
+
+    // The sums in calculate() assume the helicities of a vector meson and a real photon
+    reaction_kinematics * kinem = _amp->_kinematics;
+    if (kinem->_jp[0] != 1 || !kinem->_photon)
+    {
+        std::cout << "decay_sampler: Only available for vector mesons produced by real photons!\n";
+        return false;
+    }
+
+    // Stay just above threshold where the amplitudes vanish
+    _lo = std::max(_Emin, E_from(kinem->sth()) + 1.E-6);
+    _hi = std::max(_Emax, _lo);
+
+    _table.assign((_nE + 1) * (_nT + 1), sdme_matrices());
+
+    amplitude_clones amps(_amp, _nThreads);
+    parallel_for(_nE + 1, amps.size(), [&](int i, int thread)
+    {
+        double s = s_from(_lo + (_hi - _lo) * double(i) / double(_nE));
+        double tmin = kinem->t_man(s, PI), tmax = kinem->t_man(s, 0.);
+
+        for (int j = 0; j <= _nT; j++)
+        {
+            double t = tmin + (tmax - tmin) * double(j) / double(_nT);
+            _table[i * (_nT + 1) + j] = calculate(amps[thread], s, t);
+        }
+    });
+
+    _initialized = true;
+    return true;
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::decay_sampler::sdme_matrices jpacPhoto::decay_sampler::interpolate(double s, double t)
+{
+    reaction_kinematics * kinem = _amp->_kinematics;
+    double tmin = kinem->t_man(s, PI), tmax = kinem->t_man(s, 0.);
+
+    // Position in the grid clamped to the tabulated range
+    double u = (_hi > _lo) ? (E_from(s) - _lo) / (_hi - _lo) * double(_nE) : 0.;
+    double v = (tmax > tmin) ? (t - tmin) / (tmax - tmin) * double(_nT) : 0.;
+
+    int i = std::min(std::max(int(u), 0), _nE - 1);
+    int j = std::min(std::max(int(v), 0), _nT - 1);
+    double fu = std::min(std::max(u - double(i), 0.), 1.);
+    double fv = std::min(std::max(v - double(j), 0.), 1.);
+
+    sdme_matrices & r00 = _table[ i      * (_nT + 1) + j    ];
+    sdme_matrices & r01 = _table[ i      * (_nT + 1) + j + 1];
+    sdme_matrices & r10 = _table[(i + 1) * (_nT + 1) + j    ];
+    sdme_matrices & r11 = _table[(i + 1) * (_nT + 1) + j + 1];
+
+    sdme_matrices result;
+    for (int e = 0; e < 27; e++)
+    {
+        result[e] = (1. - fu) * ((1. - fv) * r00[e] + fv * r01[e]) 
+                  +       fu  * ((1. - fv) * r10[e] + fv * r11[e]);
+    }
+
+    return result;
+};
+
+std::complex<double> jpacPhoto::decay_sampler::SDME(int alpha, int lam, int lamp, double s, double t)
+{
+    if (alpha < 0 || alpha > 2 || std::abs(lam) > 1 || std::abs(lamp) > 1)
+    {
+        std::cout << "\ndecay_sampler: Invalid parameter passed to SDME. Returning 0!\n";
+        return 0.;
+    }
+
+    if (!initialize()) return 0.;
+
+    return interpolate(s, t)[9*alpha + 3*(lam + 1) + (lamp + 1)];
+};
+
+// ---------------------------------------------------------------------------
+std::array<std::complex<double>, 9> jpacPhoto::decay_sampler::polarized(sdme_matrices & rho, double Phi)
+{
+    std::array<std::complex<double>, 9> result;
+    for (int e = 0; e < 9; e++)
+    {
+        result[e] = rho[e] - _P * cos(2. * Phi) * rho[9 + e] - _P * sin(2. * Phi) * rho[18 + e];
+    }
+
+    return result;
+};
+
+double jpacPhoto::decay_sampler::distribution(std::array<std::complex<double>, 9> & rho, double cos_theta, double phi)
+{
+    double theta = TMath::ACos(cos_theta);
+
+    std::vector<std::array<double, 2>> mu_weights;
+    if (_mode == DECAY_MODE::TWO_PSEUDOSCALARS) mu_weights = {{0., 1.}};
+    else                                        mu_weights = {{1., 0.5}, {-1., 0.5}};
+
+    double result = 0.;
+    for (int k = 0; k < mu_weights.size(); k++)
+    {
+        int mu = int(mu_weights[k][0]);
+
+        double d[3];
+        for (int lam = -1; lam <= 1; lam++) d[lam + 1] = wigner_d_int(1, lam, mu, theta);
+
+        for (int lam = -1; lam <= 1; lam++)
+        {
+            for (int lamp = -1; lamp <= 1; lamp++)
+            {
+                std::complex<double> phase = exp(XI * double(lam - lamp) * phi);
+                result += mu_weights[k][1] * real(rho[3*(lam + 1) + (lamp + 1)] * phase) * d[lam + 1] * d[lamp + 1];
+            }
+        }
+    }
+
+    return 3. / (4. * PI) * result;
+};
+
+double jpacPhoto::decay_sampler::distribution(double s, double t, double cos_theta, double phi, double Phi)
+{
+    if (!initialize()) return 0.;
+
+    sdme_matrices rho = interpolate(s, t);
+    std::array<std::complex<double>, 9> rho_Phi = polarized(rho, Phi);
+
+    return distribution(rho_Phi, cos_theta, phi);
+};
+
+// ---------------------------------------------------------------------------
+std::vector<jpacPhoto::decay_angles> jpacPhoto::decay_sampler::sample(std::vector<std::array<double, 3>> events)
+{
+    if (!initialize()) return {};
+
+    std::vector<decay_angles> result(events.size());
+
+    int nChunks = (events.size() + _chunk - 1) / _chunk;
+    parallel_for(nChunks, _nThreads, [&](int k, int thread)
+    {
+        std::seed_seq seq{(unsigned long) _seed, (unsigned long) k};
+        std::mt19937_64 gen(seq);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+
+        int end = std::min(int(events.size()), (k + 1) * _chunk);
+        for (int i = k * _chunk; i < end; i++)
+        {
+            sdme_matrices rho = interpolate(events[i][0], events[i][1]);
+            std::array<std::complex<double>, 9> rho_Phi = polarized(rho, events[i][2]);
+
+            // W is bounded by 3/4pi times the largest eigenvalue of rho(Phi) and so by its Frobenius norm
+            double bound = 0.;
+            for (int e = 0; e < 9; e++) bound += std::norm(rho_Phi[e]);
+            bound = 3. / (4. * PI) * sqrt(bound);
+
+            decay_angles x = {0., 0.};
+            if (bound <= 0.) { result[i] = x; continue; }
+
+            do
+            {
+                x.cos_theta = 2. * uniform(gen) - 1.;
+                x.phi       = 2. * PI * uniform(gen);
+            }
+            while (uniform(gen) * bound > distribution(rho_Phi, x.cos_theta, x.phi));
+
+            result[i] = x;
+        }
+    });
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Phi is the polarization angle measured from the production plane
+std::vector<jpacPhoto::decay_angles> jpacPhoto::decay_sampler::sample(std::vector<generated_event> & events)
+{
+    std::vector<std::array<double, 3>> kinematics;
+    for (int i = 0; i < events.size(); i++)
+    {
+        double phi_X = atan2(events[i].p[2][2], events[i].p[2][1]);
+        kinematics.push_back({events[i].s, events[i].t, _polAngle - phi_X});
+    }
+
+    return sample(kinematics);
+};
@@ -0,0 +1,294 @@
+// Unweighted Monte Carlo events distributed according to the differential cross section
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/event_generator.hpp"
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::event_generator::s_from(double E)
+{
+    if (_evar == ENERGY_VARIABLE::W) return E * E;
+    return _amp->_kinematics->s_from_Egam(E);
+};
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::event_generator::density(amplitude * amp, double E, double x, double & s, double & t)
+{
+    s = s_from(E);
+    if (s <= amp->_kinematics->sth()) return 0.;
+
+    double tmin = amp->_kinematics->t_man(s, PI);
+    double tmax = amp->_kinematics->t_man(s, 0.);
+    t = tmin + x * (tmax - tmin);
+
+    double flux = (_flux) ? _flux(E) : 1.;
+    return flux * amp->differential_xsection(s, t) * (tmax - tmin);
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::event_generator::initialize()
+{
+    reaction_kinematics * kinem = _amp->_kinematics;
+
+    // Energy variable corresponding to W
+    auto E_from = [&](double W)
+    {
+        if (_evar == ENERGY_VARIABLE::W) return W;
+        return kinem->Egam_from_s(W*W);
+    };
+
+    double lo = std::max(_Emin, E_from(kinem->Wth()));
+    double hi = _Emax;
+
+    _Egrid.clear();
+    for (int i = 0; i <= _nE; i++) _Egrid.push_back(lo + (hi - lo) * double(i) / double(_nE));
+
+    // Resolve narrow structures
+    std::vector<std::array<double, 2>> poles = _amp->resonances();
+    for (int i = 0; i < poles.size(); i++)
+    {
+        for (double k : {-2., -1., -0.5, 0., 0.5, 1., 2.})
+        {
+            double E = E_from(poles[i][0] + k * poles[i][1]);
+            if (E > lo && E < hi) _Egrid.push_back(E);
+        }
+    }
+    std::sort(_Egrid.begin(), _Egrid.end());
+    _Egrid.erase(std::unique(_Egrid.begin(), _Egrid.end()), _Egrid.end());
+
+    // Density on a grid twice as fine as the cells to include midpoints
+    int nE = _Egrid.size() - 1;
+    std::vector<std::vector<double>> values(2*nE + 1, std::vector<double>(2*_nT + 1, 0.));
+
+    amplitude_clones amps(_amp, _nThreads);
+    parallel_for(2*nE + 1, amps.size(), [&](int i, int thread)
+    {
+        double E = (i % 2 == 0) ? _Egrid[i/2] : 0.5 * (_Egrid[i/2] + _Egrid[i/2 + 1]);
+        for (int j = 0; j <= 2*_nT; j++)
+        {
+            double s, t;
+            values[i][j] = density(amps[thread], E, double(j) / double(2*_nT), s, t);
+        }
+    });
+
+    _majorant.clear(); _cumulative.clear();
+    double total = 0.;
+    for (int i = 0; i < nE; i++)
+    {
+        for (int j = 0; j < _nT; j++)
+        {
+            double max = 0.;
+            for (int a = 0; a <= 2; a++)
+            {
+                for (int b = 0; b <= 2; b++) max = std::max(max, values[2*i + a][2*j + b]);
+            }
+
+            double M = _safety * max;
+            _majorant.push_back(M);
+
+            total += M * (_Egrid[i+1] - _Egrid[i]) / double(_nT);
+            _cumulative.push_back(total);
+        }
+    }
+
+    _nTrials = 0; _nAccepted = 0; _nViolations = 0; _nInvalid = 0;
+    _initialized = true;
+};
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::event_generator::integrated_rate()
+{
+    if (!_initialized) initialize();
+    if (_cumulative.size() == 0) return 0.;
+
+    return _cumulative.back() * efficiency();
+};
+
+// ---------------------------------------------------------------------------
+std::vector<jpacPhoto::generated_event> jpacPhoto::event_generator::generate_chunk(amplitude * amp, long k, int n, long & trials, long & violations, long & invalid)
+{
+    std::seed_seq seq{(unsigned long) _seed, (unsigned long) k};
+    std::mt19937_64 gen(seq);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+
+    std::vector<generated_event> events;
+    trials = 0; violations = 0; invalid = 0;
+
+    double total = _cumulative.back();
+    while (events.size() < n)
+    {
+        trials++;
+
+        // Pick a cell according to its majorant and a point uniformly inside it
+        int c = std::upper_bound(_cumulative.begin(), _cumulative.end(), uniform(gen) * total) - _cumulative.begin();
+        c = std::min(c, int(_cumulative.size()) - 1);
+
+        int i = c / _nT, j = c % _nT;
+        double E = _Egrid[i] + uniform(gen) * (_Egrid[i+1] - _Egrid[i]);
+        double x = (double(j) + uniform(gen)) / double(_nT);
+
+        generated_event event;
+        double f = density(amp, E, x, event.s, event.t);
+
+        // NaN compares false with everything so it has to be rejected explicitly
+        if (!(f >= 0.)) { invalid++; continue; }
+
+        if (f > _majorant[c]) violations++;
+        if (uniform(gen) * _majorant[c] > f) continue;
+
+        event.E = E;
+        four_vectors(event, 2. * PI * uniform(gen));
+        events.push_back(event);
+    }
+
+    return events;
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::event_generator::four_vectors(generated_event & event, double phi)
+{
+    reaction_kinematics * kinem = _amp->_kinematics;
+    double s = event.s;
+    double theta = kinem->theta_s(s, event.t);
+
+    // CoM frame with the beam along z
+    for (int mu = 0; mu < 4; mu++)
+    {
+        event.p[0][mu] = real(kinem->_initial_state->q(mu, s, 0.));
+        event.p[1][mu] = real(kinem->_initial_state->p(mu, s, 0.));
+        event.p[2][mu] = real(kinem->_final_state->q(mu, s, theta));
+        event.p[3][mu] = real(kinem->_final_state->p(mu, s, theta));
+    }
+
+    // Rotate the final state by phi around z
+    for (int a = 2; a < 4; a++)
+    {
+        double px = event.p[a][1];
+        event.p[a][1] = px * cos(phi);
+        event.p[a][2] = px * sin(phi);
+    }
+
+    if (_CoM) return;
+
+    // Boost along z to the rest frame of the target
+    double beta  = event.p[1][3] / event.p[1][0];
+    double gamma = 1. / sqrt(1. - beta*beta);
+    for (int a = 0; a < 4; a++)
+    {
+        double E = event.p[a][0], pz = event.p[a][3];
+        event.p[a][0] = gamma * (E  - beta * pz);
+        event.p[a][3] = gamma * (pz - beta * E);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Chunks are generated in parallel in batches and passed to output in order
+long jpacPhoto::event_generator::run(long N, std::function<void(std::vector<generated_event> &)> output)
+{
+    if (!_initialized) initialize();
+    if (_cumulative.size() == 0 || _cumulative.back() <= 0.)
+    {
+        std::cout << "event_generator: Cross section vanishes in the given range!\n";
+        return 0;
+    }
+
+    long nChunks = (N + _chunk - 1) / _chunk;
+    long violations_before = _nViolations, invalid_before = _nInvalid;
+
+    amplitude_clones amps(_amp, _nThreads);
+    int nBatch = 4 * amps.size();
+
+    long n = 0;
+    for (long first = 0; first < nChunks; first += nBatch)
+    {
+        int size = std::min(long(nBatch), nChunks - first);
+        std::vector<std::vector<generated_event>> chunks(size);
+        std::vector<long> trials(size), violations(size), invalid(size);
+
+        parallel_for(size, amps.size(), [&](int i, int thread)
+        {
+            long k = first + i;
+            int n_k = std::min(long(_chunk), N - k * _chunk);
+            chunks[i] = generate_chunk(amps[thread], k, n_k, trials[i], violations[i], invalid[i]);
+        });
+
+        for (int i = 0; i < size; i++)
+        {
+            output(chunks[i]);
+
+            n += chunks[i].size();
+            _nTrials += trials[i]; _nAccepted += chunks[i].size(); _nViolations += violations[i]; _nInvalid += invalid[i];
+        }
+    }
+
+    if (_nViolations > violations_before)
+    {
+        std::cout << "event_generator: Majorant exceeded " << _nViolations - violations_before << " times! ";
+        std::cout << "Consider increasing set_safety() or set_grid().\n";
+    }
+
+    if (_nInvalid > invalid_before)
+    {
+        std::cout << "event_generator: Rejected " << _nInvalid - invalid_before << " trials with negative or NaN density!\n";
+    }
+
+    return n;
+};
+
+// ---------------------------------------------------------------------------
+std::vector<jpacPhoto::generated_event> jpacPhoto::event_generator::generate(int N)
+{
+    std::vector<generated_event> result;
+    result.reserve(N);
+
+    run(N, [&](std::vector<generated_event> & events)
+    {
+        result.insert(result.end(), events.begin(), events.end());
+    });
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+long jpacPhoto::event_generator::generate(long N, std::string filename, bool binary)
+{
+    std::ofstream out;
+    (binary) ? out.open(filename, std::ios::binary) : out.open(filename);
+    if (!out.is_open())
+    {
+        std::cout << "event_generator: Cannot open file " << filename << "!\n";
+        return 0;
+    }
+
+    if (!binary)
+    {
+        out << "# E s t";
+        for (std::string particle : {"beam", "target", "X", "recoil"}) out << "  " << particle << "(E px py pz)";
+        out << "\n" << std::setprecision(9);
+    }
+
+    return run(N, [&](std::vector<generated_event> & events)
+    {
+        for (int i = 0; i < events.size(); i++)
+        {
+            generated_event & event = events[i];
+
+            double x[19] = {event.E, event.s, event.t};
+            for (int a = 0; a < 4; a++)
+            {
+                for (int mu = 0; mu < 4; mu++) x[3 + 4*a + mu] = event.p[a][mu];
+            }
+
+            if (binary) 
+            {
+                out.write(reinterpret_cast<const char*>(x), 19 * sizeof(double));
+                continue;
+            }
+
+            for (int k = 0; k < 19; k++) out << x[k] << ((k < 18) ? " " : "\n");
+        }
+    });
+};
@@ -0,0 +1,350 @@
+// Per-event storage of component helicity amplitudes and reweighting to new couplings
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/event_store.hpp"
+
+#include <cstring>
+
+namespace jpacPhoto
+{
+    // Identifies the binary format in the first bytes of a file
+    static const char EVENT_STORE_MAGIC[8] = {'J', 'P', 'A', 'C', 'E', 'V', 'T', '2'};
+    static const uint32_t EVENT_STORE_VERSION = 2;
+    static const uint32_t EVENT_STORE_ENDIAN  = 0x01020304;
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::event_store::event_store(std::vector<amplitude*> components, bool monomials)
+: _components(components)
+{
+    if (_components.size() == 0) return;
+
+    reaction_kinematics * kinem = _components[0]->_kinematics;
+
+    // Save helicities which any component may populate
+    for (int h = 0; h < kinem->_nAmps; h++)
+    {
+        for (int c = 0; c < _components.size(); c++)
+        {
+            if (_components[c]->is_nonzero(kinem->_helicities[h]))
+            {
+                _active.push_back(h);
+                break;
+            }
+        }
+    }
+
+    for (int c = 0; c < _components.size(); c++)
+    {
+        int nM = (monomials) ? _components[c]->n_monomials() : 0;
+
+        _nMonomials.push_back(nM);
+        _offsets.push_back(_size);
+        _size += _active.size() * (1 + nM);
+    }
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::event_store::evaluate(std::vector<amplitude*> & components, stored_event & event)
+{
+    int n = _components[0]->_kinematics->_nAmps;
+    event.values.assign(_size, 0.);
+    event.kinematics.assign(components.size(), {});
+
+    for (int c = 0; c < components.size(); c++)
+    {
+        amplitude * amp = components[c];
+        std::complex<double> * values = event.values.data() + _offsets[c];
+
+        amp->check_cache(event.s, event.t);
+        for (int a = 0; a < _active.size(); a++) values[a] = amp->_cached_helicity_amplitude[_active[a]];
+
+        int nM = _nMonomials[c];
+        if (nM == 0) continue;
+
+        event.kinematics[c] = amp->monomial_kinematics(event.s, event.t);
+
+        // Structures related by parity the same way as the amplitudes
+        std::vector<std::vector<std::complex<double>>> B(n);
+        for (int a = 0; a < _active.size(); a++)
+        {
+            int h = _active[a];
+            if (!amp->_helicity_mask[h]) continue;
+
+            if (amp->_useParity && h >= n/2 && B[n-1-h].size() == nM)
+            {
+                double eta = double(amp->_parity_phases[n-1-h]);
+                for (int m = 0; m < nM; m++) B[h].push_back(eta * B[n-1-h][m]);
+            }
+            else
+            {
+                B[h] = amp->monomial_amplitudes(amp->_kinematics->_helicities[h], event.s, event.t);
+            }
+
+            for (int m = 0; m < nM; m++) values[_active.size() + a*nM + m] = B[h][m];
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::event_store::add_event(double s, double t, double w)
+{
+    add_events({{s, t}}, {w});
+};
+
+void jpacPhoto::event_store::add_events(std::vector<std::array<double, 2>> points, std::vector<double> weights)
+{
+    if (_components.size() == 0) return;
+
+    int start = _events.size();
+    for (int i = 0; i < points.size(); i++)
+    {
+        double w = (i < weights.size()) ? weights[i] : 1.;
+        _events.push_back({points[i][0], points[i][1], w, {}});
+    }
+
+    component_clones amps(_components, _nThreads);
+    parallel_for(points.size(), amps.size(), [&](int i, int thread)
+    {
+        std::vector<amplitude*> components = amps[thread];
+        evaluate(components, _events[start + i]);
+    });
+};
+
+// ---------------------------------------------------------------------------
+// Header, saved helicities and monomials per component, then each event
+bool jpacPhoto::event_store::write(std::string filename)
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open())
+    {
+        std::cout << "event_store: Cannot open file " << filename << "!\n";
+        return false;
+    }
+
+    event_store_header header;
+    std::memcpy(header.magic, EVENT_STORE_MAGIC, 8);
+    header.version     = EVENT_STORE_VERSION;
+    header.endian      = EVENT_STORE_ENDIAN;
+    header.nComponents = _components.size();
+    header.nActive     = _active.size();
+    header.nEvents     = _events.size();
+    header.value_size  = _size * sizeof(std::complex<double>);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<int32_t> ints(_active.begin(), _active.end());
+    ints.insert(ints.end(), _nMonomials.begin(), _nMonomials.end());
+    out.write(reinterpret_cast<const char*>(ints.data()), ints.size() * sizeof(int32_t));
+
+    for (int i = 0; i < _events.size(); i++)
+    {
+        double x[3] = {_events[i].s, _events[i].t, _events[i].w};
+        out.write(reinterpret_cast<const char*>(x), 3 * sizeof(double));
+        out.write(reinterpret_cast<const char*>(_events[i].values.data()), header.value_size);
+
+        for (int c = 0; c < _components.size(); c++)
+        {
+            if (_nMonomials[c] == 0) continue;
+
+            const std::vector<std::complex<double>> & k = _events[i].kinematics[c];
+            uint32_t nK = k.size();
+            out.write(reinterpret_cast<const char*>(&nK), sizeof(uint32_t));
+            out.write(reinterpret_cast<const char*>(k.data()), nK * sizeof(std::complex<double>));
+        }
+    }
+
+    return out.good();
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::event_store::read(std::string filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+    {
+        std::cout << "event_store: Cannot open file " << filename << "!\n";
+        return false;
+    }
+
+    event_store_header header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    bool valid = in.good() && std::equal(header.magic, header.magic + 8, EVENT_STORE_MAGIC);
+    valid = valid && header.version == EVENT_STORE_VERSION && header.endian == EVENT_STORE_ENDIAN;
+    if (!valid)
+    {
+        std::cout << "event_store: File " << filename << " is not an event file of this version or byte order!\n";
+        return false;
+    }
+
+    bool consistent = header.nComponents == _components.size() && header.nActive == _active.size();
+    consistent = consistent && header.value_size == _size * sizeof(std::complex<double>);
+
+    std::vector<int32_t> ints(_active.size() + _components.size());
+    if (consistent) in.read(reinterpret_cast<char*>(ints.data()), ints.size() * sizeof(int32_t));
+    for (int a = 0; consistent && a < _active.size(); a++)      consistent = (ints[a] == _active[a]);
+    for (int c = 0; consistent && c < _components.size(); c++)  consistent = (ints[_active.size() + c] == _nMonomials[c]);
+
+    if (!consistent || !in.good())
+    {
+        std::cout << "event_store: File " << filename << " does not match the components of this store!\n";
+        return false;
+    }
+
+    uint64_t N = header.nEvents;
+
+    _events.clear();
+    _events.reserve(N);
+    for (uint64_t i = 0; i < N; i++)
+    {
+        double x[3];
+        stored_event event;
+        event.values.resize(_size);
+        event.kinematics.resize(_components.size());
+
+        in.read(reinterpret_cast<char*>(x), 3 * sizeof(double));
+        in.read(reinterpret_cast<char*>(event.values.data()), header.value_size);
+        for (int c = 0; in.good() && c < _components.size(); c++)
+        {
+            if (_nMonomials[c] == 0) continue;
+
+            uint32_t nK = 0;
+            in.read(reinterpret_cast<char*>(&nK), sizeof(uint32_t));
+            event.kinematics[c].resize(nK);
+            in.read(reinterpret_cast<char*>(event.kinematics[c].data()), nK * sizeof(std::complex<double>));
+        }
+
+        if (!in.good())
+        {
+            std::cout << "event_store: File " << filename << " ended after " << i << " of " << N << " events!\n";
+            return false;
+        }
+
+        event.s = x[0]; event.t = x[1]; event.w = x[2];
+        _events.push_back(event);
+    }
+
+    return true;
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::reweighter::reset()
+{
+    int nC = _store->_components.size();
+    _included.assign(nC, true);
+    _newParams.assign(nC, false);
+    _params.assign(nC, {});
+};
+
+void jpacPhoto::reweighter::set_components(std::vector<int> which)
+{
+    _included.assign(_store->_components.size(), false);
+    for (int i = 0; i < which.size(); i++)
+    {
+        if (which[i] < 0 || which[i] >= _included.size())
+        {
+            std::cout << "reweighter: Component index " << which[i] << " out of range!\n";
+            continue;
+        }
+        _included[which[i]] = true;
+    }
+};
+
+void jpacPhoto::reweighter::set_params(int c, std::vector<double> params)
+{
+    if (c < 0 || c >= _store->_components.size()) 
+    {
+        std::cout << "reweighter: Component index " << c << " out of range!\n";
+        return;
+    }
+
+    if (_store->_nMonomials[c] == 0)
+    {
+        std::cout << "reweighter: Component " << _store->_components[c]->_identifier << " was not saved with monomials. Parameters not changed!\n";
+        return;
+    }
+
+    _store->_components[c]->check_nParams(params);
+    _params[c] = params;
+    _newParams[c] = true;
+};
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::reweighter::stored_probability(stored_event & event)
+{
+    int nA = _store->_active.size();
+
+    double result = 0.;
+    for (int a = 0; a < nA; a++)
+    {
+        std::complex<double> A = 0.;
+        for (int c = 0; c < _store->_components.size(); c++) A += event.values[_store->_offsets[c] + a];
+
+        result += std::norm(A);
+    }
+
+    return result;
+};
+
+std::vector<double> jpacPhoto::reweighter::probabilities()
+{
+    std::vector<stored_event> & events = _store->_events;
+    std::vector<double> result(events.size(), 0.);
+
+    int nA = _store->_active.size();
+    int nC = _store->_components.size();
+
+    if (!_amps) _amps.reset(new component_clones(_store->_components, _nThreads));
+
+    parallel_for(events.size(), _amps->size(), [&](int i, int thread)
+    {
+        std::vector<amplitude*> components = (*_amps)[thread];
+        stored_event & event = events[i];
+
+        std::vector<std::complex<double>> A(nA, 0.);
+        for (int c = 0; c < nC; c++)
+        {
+            if (!_included[c]) continue;
+
+            const std::complex<double> * values = event.values.data() + _store->_offsets[c];
+
+            if (!_newParams[c])
+            {
+                for (int a = 0; a < nA; a++) A[a] += values[a];
+                continue;
+            }
+
+            // Recombine the structures with the new coefficients
+            int nM = _store->_nMonomials[c];
+            std::vector<std::complex<double>> coeffs = components[c]->saved_coupling_monomials(_params[c], event.kinematics[c]);
+            for (int a = 0; a < nA; a++)
+            {
+                for (int m = 0; m < nM; m++) A[a] += coeffs[m] * values[nA + a*nM + m];
+            }
+        }
+
+        for (int a = 0; a < nA; a++) result[i] += std::norm(A[a]);
+    });
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+std::vector<double> jpacPhoto::reweighter::weights()
+{
+    std::vector<double> result = probabilities();
+
+    for (int i = 0; i < result.size(); i++)
+    {
+        stored_event & event = _store->_events[i];
+        double P0 = stored_probability(event);
+
+        result[i] = (P0 > 0.) ? event.w * result[i] / P0 : 0.;
+    }
+
+    return result;
+};
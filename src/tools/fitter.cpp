@@ -0,0 +1,279 @@
+// Chi-squared fits of amplitude parameters to data sets using Minuit2
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/fitter.hpp"
+
+// ---------------------------------------------------------------------------
+int jpacPhoto::fitter::add_data(data_set data)
+{
+    reaction_kinematics * kinem = _amp->_kinematics;
+
+    std::vector<fit_point> new_points;
+    for (int i = 0; i < data._points.size(); i++)
+    {
+        data_point x = data._points[i];
+
+        double s = (data._evar == ENERGY_VARIABLE::W) ? x.E * x.E : kinem->s_from_Egam(x.E);
+
+        // Skip points which cannot be described by the amplitude
+        if (s <= kinem->sth()) continue;
+        if (!data._tIntegrated && (x.t > kinem->t_man(s, 0.) || x.t < kinem->t_man(s, PI))) continue;
+
+        if (x.error <= 0.)
+        {
+            std::cout << "fitter: Point with non-positive error in " << data._identifier << " skipped!\n";
+            continue;
+        }
+
+        new_points.push_back({int(_data.size()), s, x.t, x.value, x.error});
+    }
+
+    int skipped = data._points.size() - new_points.size();
+    if (skipped > 0)
+    {
+        std::cout << "fitter: " << skipped << " points of " << data._identifier << " outside the physical region skipped.\n";
+    }
+
+    std::stable_sort(new_points.begin(), new_points.end(), [](const fit_point & a, const fit_point & b)
+    {
+        return a.s < b.s;
+    });
+
+    _points.insert(_points.end(), new_points.begin(), new_points.end());
+    _data.push_back(data);
+
+    return new_points.size();
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::fitter::set_parameter(int i, std::string name, double start, double step)
+{
+    if (i < 0 || i >= _pars.size())
+    {
+        std::cout << "fitter: Parameter index " << i << " out of range for " << _amp->_identifier << "!\n";
+        return;
+    }
+
+    _pars[i].name  = name;
+    _pars[i].start = start;
+    _pars[i].step  = step;
+};
+
+void jpacPhoto::fitter::set_limits(int i, double lo, double hi)
+{
+    if (i < 0 || i >= _pars.size()) return;
+
+    _pars[i].lo = lo;
+    _pars[i].hi = hi;
+    _pars[i].limited = true;
+};
+
+void jpacPhoto::fitter::fix_parameter(int i, double value)
+{
+    if (i < 0 || i >= _pars.size()) return;
+
+    _pars[i].start = value;
+    _pars[i].fixed = true;
+};
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::fitter::chi2(std::vector<double> params)
+{
+    if (_clones == NULL) _clones = new amplitude_clones(_amp, _nThreads);
+
+    for (int i = 0; i < _clones->size(); i++) (*_clones)[i]->set_params(params);
+
+    // Partial sums per chunk so the total does not depend on the number of threads
+    int nChunks = (_points.size() + _chunk - 1) / _chunk;
+    std::vector<double> partial(nChunks, 0.);
+
+    parallel_for(nChunks, _clones->size(), [&](int c, int thread)
+    {
+        amplitude * amp = (*_clones)[thread];
+
+        int end = std::min(int(_points.size()), (c + 1) * _chunk);
+        for (int i = c * _chunk; i < end; i++)
+        {
+            fit_point & x = _points[i];
+            double residual = (_data[x.set]._F(amp, x.s, x.t) - x.value) / x.error;
+            partial[c] += residual * residual;
+        }
+    });
+
+    double result = 0.;
+    for (int c = 0; c < nChunks; c++) result += partial[c];
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::fitter::gradient_available()
+{
+    if (!_amp->gradient_available()) return false;
+
+    for (int i = 0; i < _data.size(); i++)
+    {
+        if (!_data[i]._dF) return false;
+    }
+
+    return true;
+};
+
+// ---------------------------------------------------------------------------
+// d chi2 / dp = sum_i 2 (F_i - value_i) / error_i^2 dF_i / dp
+double jpacPhoto::fitter::chi2(std::vector<double> params, std::vector<double> & gradient)
+{
+    if (_clones == NULL) _clones = new amplitude_clones(_amp, _nThreads);
+
+    for (int i = 0; i < _clones->size(); i++) (*_clones)[i]->set_params(params);
+
+    int nPars = params.size();
+    int nChunks = (_points.size() + _chunk - 1) / _chunk;
+    std::vector<double> partial(nChunks, 0.);
+    std::vector<std::vector<double>> partial_gradient(nChunks, std::vector<double>(nPars, 0.));
+
+    parallel_for(nChunks, _clones->size(), [&](int c, int thread)
+    {
+        amplitude * amp = (*_clones)[thread];
+        std::vector<double> dF;
+
+        int end = std::min(int(_points.size()), (c + 1) * _chunk);
+        for (int i = c * _chunk; i < end; i++)
+        {
+            fit_point & x = _points[i];
+            double residual = (_data[x.set]._dF(amp, x.s, x.t, dF) - x.value) / x.error;
+            partial[c] += residual * residual;
+
+            for (int k = 0; k < nPars && k < dF.size(); k++)
+            {
+                partial_gradient[c][k] += 2. * residual * dF[k] / x.error;
+            }
+        }
+    });
+
+    double result = 0.;
+    gradient.assign(nPars, 0.);
+    for (int c = 0; c < nChunks; c++)
+    {
+        result += partial[c];
+        for (int k = 0; k < nPars; k++) gradient[k] += partial_gradient[c][k];
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+// Wrapper to give Minuit chi2 with its gradient
+namespace jpacPhoto
+{
+    class chi2_gradient_function : public ROOT::Math::IMultiGradFunction
+    {
+        public:
+
+        chi2_gradient_function(fitter * fit, int n)
+        : _fitter(fit), _n(n)
+        {};
+
+        unsigned int NDim() const { return _n; };
+
+        ROOT::Math::IMultiGenFunction * Clone() const
+        {
+            return new chi2_gradient_function(_fitter, _n);
+        };
+
+        void Gradient(const double * x, double * grad) const
+        {
+            double f;
+            FdF(x, f, grad);
+        };
+
+        void FdF(const double * x, double & f, double * grad) const
+        {
+            std::vector<double> gradient;
+            f = _fitter->chi2(std::vector<double>(x, x + _n), gradient);
+            for (int i = 0; i < _n; i++) grad[i] = gradient[i];
+        };
+
+        private:
+
+        fitter * _fitter;
+        int _n;
+
+        double DoEval(const double * x) const
+        {
+            return _fitter->chi2(std::vector<double>(x, x + _n));
+        };
+
+        double DoDerivative(const double * x, unsigned int i) const
+        {
+            std::vector<double> gradient;
+            _fitter->chi2(std::vector<double>(x, x + _n), gradient);
+            return gradient[i];
+        };
+    };
+};
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::fitter::do_fit()
+{
+    int nPars = _pars.size();
+
+    ROOT::Math::Minimizer * minuit = ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad");
+    minuit->SetMaxFunctionCalls(_maxCalls);
+    minuit->SetTolerance(_tolerance);
+    minuit->SetPrintLevel(_printLevel);
+
+    // Use exact gradients if possible, otherwise Minuit uses finite differences
+    auto fcn = [&](const double * x)
+    {
+        return chi2(std::vector<double>(x, x + nPars));
+    };
+    ROOT::Math::Functor functor(fcn, nPars);
+    chi2_gradient_function gradient_functor(this, nPars);
+
+    if (gradient_available()) minuit->SetFunction(gradient_functor);
+    else                      minuit->SetFunction(functor);
+
+    for (int i = 0; i < nPars; i++)
+    {
+        parameter & p = _pars[i];
+        if      (p.fixed)   minuit->SetFixedVariable(i, p.name, p.start);
+        else if (p.limited) minuit->SetLimitedVariable(i, p.name, p.start, p.step, p.lo, p.hi);
+        else                minuit->SetVariable(i, p.name, p.start, p.step);
+    }
+
+    minuit->Minimize();
+
+    _chi2   = minuit->MinValue();
+    _best   = std::vector<double>(minuit->X(), minuit->X() + nPars);
+    _errors = std::vector<double>(minuit->Errors(), minuit->Errors() + nPars);
+
+    delete minuit;
+
+    // Leave the amplitude at the minimum
+    _amp->set_params(_best);
+
+    std::cout << std::left << "\nFit of " << _amp->_identifier << " to " << _points.size() << " points: \n";
+    std::cout << "chi2 = " << _chi2 << ", chi2/dof = " << chi2_dof() << "\n";
+    for (int i = 0; i < nPars; i++)
+    {
+        std::cout << std::setw(15) << _pars[i].name << std::setw(15) << _best[i];
+        (_pars[i].fixed) ? (std::cout << "(fixed)\n") : (std::cout << "+/- " << _errors[i] << "\n");
+    }
+
+    return _chi2;
+};
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::fitter::chi2_dof()
+{
+    int nFree = 0;
+    for (int i = 0; i < _pars.size(); i++) if (!_pars[i].fixed) nFree++;
+
+    int dof = _points.size() - nFree;
+    return (dof > 0) ? _chi2 / double(dof) : 0.;
+};
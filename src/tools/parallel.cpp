@@ -0,0 +1,64 @@
+// Utilities to evaluate amplitudes in parallel over many kinematic points
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/parallel.hpp"
+
+#include <thread>
+#include <atomic>
+
+namespace jpacPhoto
+{
+    static int N_THREADS = std::max(1, int(std::thread::hardware_concurrency()));
+};
+
+// ---------------------------------------------------------------------------
+int jpacPhoto::get_threads()
+{
+    return N_THREADS;
+};
+
+void jpacPhoto::set_threads(int n)
+{
+    N_THREADS = std::max(1, n);
+};
+
+// ---------------------------------------------------------------------------
+// Tasks are handed out one at a time so uneven costs (e.g. near resonances) balance out
+void jpacPhoto::parallel_for(int N, int nThreads, std::function<void(int, int)> task)
+{
+    nThreads = std::max(1, std::min(nThreads, N));
+    if (nThreads == 1)
+    {
+        for (int i = 0; i < N; i++) task(i, 0);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    auto work = [&](int thread)
+    {
+        for (int i = next++; i < N; i = next++) task(i, thread);
+    };
+
+    std::vector<std::thread> threads;
+    for (int n = 1; n < nThreads; n++) threads.push_back(std::thread(work, n));
+    work(0);
+
+    for (int n = 0; n < threads.size(); n++) threads[n].join();
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::amplitude_clones::amplitude_clones(amplitude * amp, int n)
+{
+    _copies.push_back(amp);
+    for (int i = 1; i < n; i++)
+    {
+        amplitude * copy = amp->clone();
+        if (copy == NULL) break;
+
+        _copies.push_back(copy);
+    }
+};
@@ -0,0 +1,154 @@
+// Fixed quadrature rules shared by the integration tools
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/quadrature.hpp"
+#include "constants.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Roots of P_n(x) by Newton iteration starting from the asymptotic estimate
+void jpacPhoto::gauss_legendre(int n, std::vector<double> & x, std::vector<double> & w)
+{
+    x.assign(n, 0.);
+    w.assign(n, 0.);
+
+    for (int i = 0; i < (n + 1) / 2; i++)
+    {
+        double z = cos(PI * (i + 0.75) / (n + 0.5));
+        double dp;
+        for (int iter = 0; iter < 100; iter++)
+        {
+            // P_n(z) and its derivative from the three term recurrence
+            double p0 = 1., p1 = z;
+            for (int k = 2; k <= n; k++)
+            {
+                double p2 = ((2.*k - 1.) * z * p1 - (k - 1.) * p0) / k;
+                p0 = p1; p1 = p2;
+            }
+
+            dp = n * (z * p1 - p0) / (z*z - 1.);
+
+            double dz = p1 / dp;
+            z -= dz;
+            if (std::abs(dz) < 1.E-15) break;
+        }
+
+        x[i] = -z; x[n - 1 - i] = z;
+        w[i] = 2. / ((1. - z*z) * dp * dp);
+        w[n - 1 - i] = w[i];
+    }
+};
+
+// ---------------------------------------------------------------------------
+std::array<std::vector<double>, 2> jpacPhoto::gauss_legendre(int n, double a, double b)
+{
+    std::vector<double> x, w;
+    gauss_legendre(n, x, w);
+
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = (a + b) / 2. + (b - a) / 2. * x[i];
+        w[i] *= (b - a) / 2.;
+    }
+
+    return {x, w};
+};
+
+// ---------------------------------------------------------------------------
+// Interior nodes are the roots of P'_{n-1}(x), found by Newton iteration from the Chebyshev-Lobatto points
+void jpacPhoto::gauss_lobatto(int n, std::vector<double> & x, std::vector<double> & w)
+{
+    x.assign(n, 0.);
+    w.assign(n, 0.);
+
+    int N = n - 1;
+    for (int i = 0; i < (n + 1) / 2; i++)
+    {
+        double z = cos(PI * i / N);
+        double p1;
+        for (int iter = 0; iter < 100; iter++)
+        {
+            // P_N(z) and P_{N-1}(z) from the three term recurrence
+            double p0 = 1.;
+            p1 = z;
+            for (int k = 2; k <= N; k++)
+            {
+                double p2 = ((2.*k - 1.) * z * p1 - (k - 1.) * p0) / k;
+                p0 = p1; p1 = p2;
+            }
+
+            // The endpoints are fixed
+            if (i == 0) break;
+
+            // (1 - z^2) P'_N = N (P_{N-1} - z P_N), Newton step on P'_N using its derivative from Legendre's equation
+            double dp  = N * (p0 - z * p1) / (1. - z*z);
+            double ddp = (2. * z * dp - N * (N + 1.) * p1) / (1. - z*z);
+
+            double dz = dp / ddp;
+            z -= dz;
+            if (std::abs(dz) < 1.E-15) break;
+        }
+
+        x[i] = -z; x[n - 1 - i] = z;
+        w[i] = 2. / (N * n * p1 * p1);
+        w[n - 1 - i] = w[i];
+    }
+};
+
+// ---------------------------------------------------------------------------
+std::array<std::vector<double>, 2> jpacPhoto::gauss_lobatto(int n, double a, double b)
+{
+    std::vector<double> x, w;
+    gauss_lobatto(n, x, w);
+
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = (a + b) / 2. + (b - a) / 2. * x[i];
+        w[i] *= (b - a) / 2.;
+    }
+
+    // Make sure endpoints are exact so nodes can be matched between adjacent intervals
+    x[0] = a; x[n - 1] = b;
+
+    return {x, w};
+};
+
+// ---------------------------------------------------------------------------
+// The first coordinate is the van der Corput sequence, the second uses the primitive polynomial x + 1
+// for which the direction numbers satisfy m_k = 2 m_{k-1} ^ m_{k-1} with m_1 = 1
+std::vector<std::array<double, 2>> jpacPhoto::sobol_2d(int n)
+{
+    int m = 0;
+    while ((1 << m) < n && m < 30) m++;
+    n = 1 << m;
+
+    std::vector<uint32_t> v1(m), v2(m);
+    uint32_t mk = 1;
+    for (int k = 0; k < m; k++)
+    {
+        if (k > 0) mk = (mk << 1) ^ mk;
+        v1[k] = uint32_t(1) << (31 - k);
+        v2[k] = mk << (31 - k);
+    }
+
+    std::vector<std::array<double, 2>> result(n);
+    double shift = 0.5 / n;
+    for (int i = 0; i < n; i++)
+    {
+        uint32_t x1 = 0, x2 = 0;
+        for (int k = 0; k < m; k++)
+        {
+            if ((i >> k) & 1) { x1 ^= v1[k]; x2 ^= v2[k]; };
+        }
+
+        result[i] = {x1 / 4294967296. + shift, x2 / 4294967296. + shift};
+    }
+
+    return result;
+};
@@ -0,0 +1,219 @@
+// Averages of observables over regions in energy and momentum transfer (or angle)
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/region_average.hpp"
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::region_average::s_from(double E)
+{
+    if (_evar == ENERGY_VARIABLE::W) return E * E;
+    return _amp->_kinematics->s_from_Egam(E);
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::region_average::angular_range(amplitude * amp, double s, double Amin, double Amax, double & lo, double & hi)
+{
+    if (s <= amp->_kinematics->sth()) return false;
+
+    if (_avar == ANGULAR_VARIABLE::T)
+    {
+        lo = std::max(Amin, amp->_kinematics->t_man(s, PI));
+        hi = std::min(Amax, amp->_kinematics->t_man(s, 0.));
+    }
+    else
+    {
+        lo = std::max(Amin, 0.);
+        hi = std::min(Amax, PI);
+    }
+
+    return (lo <= hi);
+};
+
+// ---------------------------------------------------------------------------
+std::array<double, 2> jpacPhoto::region_average::angular_integral(amplitude * amp, observable & F, double E, double Amin, double Amax)
+{
+    double s = s_from(E);
+
+    // Physical region at this energy
+    double lo, hi;
+    if (!angular_range(amp, s, Amin, Amax, lo, hi)) return {0., 0.};
+
+    auto t_from = [&](double A)
+    {
+        return (_avar == ANGULAR_VARIABLE::T) ? A : amp->_kinematics->t_man(s, A);
+    };
+
+    // Single value of the angular variable
+    if (Amin == Amax) return {F(amp, s, t_from(lo)), 1.};
+
+    double sum = 0.;
+    double width = (hi - lo) / double(_nA);
+    for (int i = 0; i < _nA; i++)
+    {
+        std::array<std::vector<double>, 2> xw = gauss_legendre(_order, lo + i * width, lo + (i+1) * width);
+        for (int j = 0; j < _order; j++)
+        {
+            sum += xw[1][j] * F(amp, s, t_from(xw[0][j]));
+        }
+    }
+
+    return {sum, hi - lo};
+};
+
+// ---------------------------------------------------------------------------
+std::array<double, 2> jpacPhoto::region_average::cell_integral(amplitude * amp, observable & F, double E0, double E1, double Amin, double Amax)
+{
+    std::array<double, 2> result = {0., 0.};
+
+    std::array<std::vector<double>, 2> xw = gauss_legendre(_order, E0, E1);
+    for (int i = 0; i < _order; i++)
+    {
+        std::array<double, 2> inner = angular_integral(amp, F, xw[0][i], Amin, Amax);
+        result[0] += xw[1][i] * inner[0];
+        result[1] += xw[1][i] * inner[1];
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+double jpacPhoto::region_average::eval(observable F, double Emin, double Emax, double Amin, double Amax)
+{
+    // Single energy
+    if (Emin == Emax)
+    {
+        std::array<double, 2> inner = angular_integral(_amp, F, Emin, Amin, Amax);
+        return (inner[1] > 0.) ? inner[0] / inner[1] : 0.;
+    }
+
+    if (_useVegas && Amin != Amax) return vegas_eval(F, Emin, Emax, Amin, Amax);
+
+    amplitude_clones amps(_amp, _nThreads);
+
+    // Each cell is stored as {E0, E1} with its current estimate {int F, int 1}
+    struct cell
+    {
+        double E0, E1;
+        std::array<double, 2> whole;
+        std::array<double, 2> left, right;
+    };
+
+    std::vector<cell> pending;
+    double width = (Emax - Emin) / double(_nE);
+    for (int i = 0; i < _nE; i++)
+    {
+        cell x;
+        x.E0 = Emin + i * width;
+        x.E1 = Emin + (i + 1) * width;
+        pending.push_back(x);
+    }
+
+    // Estimate of the whole cells for the initial grid
+    parallel_for(pending.size(), amps.size(), [&](int i, int thread)
+    {
+        pending[i].whole = cell_integral(amps[thread], F, pending[i].E0, pending[i].E1, Amin, Amax);
+    });
+
+    double total_estimate = 0.;
+    for (int i = 0; i < pending.size(); i++) total_estimate += std::abs(pending[i].whole[0]);
+
+    std::array<double, 2> result = {0., 0.};
+    int nCells = pending.size();
+    while (!pending.empty())
+    {
+        // Evaluate both halves of every pending cell in parallel
+        parallel_for(pending.size(), amps.size(), [&](int i, int thread)
+        {
+            double mid = (pending[i].E0 + pending[i].E1) / 2.;
+            pending[i].left  = cell_integral(amps[thread], F, pending[i].E0, mid, Amin, Amax);
+            pending[i].right = cell_integral(amps[thread], F, mid, pending[i].E1, Amin, Amax);
+        });
+
+        // Accept or split cells in order so the result is independent of the number of threads
+        std::vector<cell> next;
+        for (int i = 0; i < pending.size(); i++)
+        {
+            cell & x = pending[i];
+            double halves = x.left[0] + x.right[0];
+            double error  = std::abs(halves - x.whole[0]);
+            double share  = (x.E1 - x.E0) / (Emax - Emin);
+
+            if (error <= _tolerance * total_estimate * share || nCells >= _maxCells)
+            {
+                result[0] += halves;
+                result[1] += x.left[1] + x.right[1];
+                continue;
+            }
+
+            double mid = (x.E0 + x.E1) / 2.;
+            cell l, r;
+            l.E0 = x.E0; l.E1 = mid;    l.whole = x.left;
+            r.E0 = mid;  r.E1 = x.E1;   r.whole = x.right;
+            next.push_back(l);
+            next.push_back(r);
+            nCells++;
+        }
+
+        pending = next;
+    }
+
+    if (nCells >= _maxCells)
+    {
+        std::cout << "region_average: Maximum number of cells (" << _maxCells << ") reached before tolerance was met! \n";
+    }
+
+    return (result[1] > 0.) ? result[0] / result[1] : 0.;
+};
+
+// ---------------------------------------------------------------------------
+// Integrate F (hi - lo) over E and x in [0, 1] with A = lo + x (hi - lo) 
+// The measure only needs the kinematics and is integrated with the Gauss-Legendre rule
+double jpacPhoto::region_average::vegas_eval(observable & F, double Emin, double Emax, double Amin, double Amax)
+{
+    amplitude_clones amps(_amp, _nThreads);
+    _vegas.set_threads(amps.size());
+
+    auto dF = [&](const double * x, int thread)
+    {
+        amplitude * amp = amps[thread];
+        double s = s_from(x[0]);
+
+        double lo, hi;
+        if (!angular_range(amp, s, Amin, Amax, lo, hi)) return 0.;
+
+        double A = lo + x[1] * (hi - lo);
+        double t = (_avar == ANGULAR_VARIABLE::T) ? A : amp->_kinematics->t_man(s, A);
+
+        return F(amp, s, t) * (hi - lo);
+    };
+
+    // Start at threshold if it is inside the region
+    reaction_kinematics * kinem = _amp->_kinematics;
+    double Eth = (_evar == ENERGY_VARIABLE::W) ? kinem->Wth() : kinem->Egam_from_s(kinem->sth());
+    Emin = std::max(Emin, Eth);
+    if (Emin >= Emax) return 0.;
+
+    vegas_result integral = _vegas.integrate(dF, {Emin, 0.}, {Emax, 1.});
+    _error = integral.error;
+
+    // The measure has kinks where the bounds are clipped so many cells are used
+    // (cheap since no amplitudes are evaluated)
+    int nCells = 64 * _nE;
+    double area = 0.;
+    double width = (Emax - Emin) / double(nCells);
+    for (int i = 0; i < nCells; i++)
+    {
+        std::array<std::vector<double>, 2> xw = gauss_legendre(_order, Emin + i * width, Emin + (i+1) * width);
+        for (int j = 0; j < _order; j++)
+        {
+            double lo, hi;
+            if (angular_range(_amp, s_from(xw[0][j]), Amin, Amax, lo, hi)) area += xw[1][j] * (hi - lo);
+        }
+    }
+
+    return (area > 0.) ? integral.value / area : 0.;
+};
@@ -0,0 +1,671 @@
+// Scans of observables described by a configuration file instead of a dedicated executable
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/scan_config.hpp"
+
+#include "amplitudes/vector_exchange.hpp"
+#include "amplitudes/pseudoscalar_exchange.hpp"
+#include "amplitudes/dirac_exchange.hpp"
+#include "amplitudes/rarita_exchange.hpp"
+#include "amplitudes/pomeron_exchange.hpp"
+#include "amplitudes/baryon_resonance.hpp"
+#include "amplitudes/primakoff_effect.hpp"
+#include "amplitudes/amplitude_sum.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace jpacPhoto
+{
+    // Names which may be used for numbers in configuration files
+    static const std::map<std::string, double> CONFIG_CONSTANTS =
+    {
+        {"PI", PI},
+        {"M_PION", M_PION}, {"M_KAON", M_KAON}, {"M_ETA", M_ETA},
+        {"M_RHO", M_RHO}, {"M_OMEGA", M_OMEGA}, {"M_PHI", M_PHI},
+        {"M_JPSI", M_JPSI}, {"M_PSI2S", M_PSI2S}, {"M_D", M_D}, {"M_DSTAR", M_DSTAR},
+        {"M_UPSILON1S", M_UPSILON1S}, {"M_UPSILON2S", M_UPSILON2S}, {"M_UPSILON3S", M_UPSILON3S},
+        {"M_CHIC1", M_CHIC1}, {"M_X3872", M_X3872}, {"M_Y4260", M_Y4260},
+        {"M_ZC3900", M_ZC3900}, {"M_ZB10610", M_ZB10610}, {"M_ZB10650", M_ZB10650},
+        {"M_PROTON", M_PROTON}, {"M_LAMBDAC", M_LAMBDAC},
+        {"F_JPSI", F_JPSI}, {"F_UPSILON1S", F_UPSILON1S}, {"F_UPSILON2S", F_UPSILON2S}, {"F_UPSILON3S", F_UPSILON3S}
+    };
+
+    static const std::map<std::string, observable> CONFIG_OBSERVABLES =
+    {
+        {"integrated_xsection",      [](amplitude * a, double s, double t){ return a->integrated_xsection(s); }},
+        {"differential_xsection",    [](amplitude * a, double s, double t){ return a->differential_xsection(s, t); }},
+        {"probability_distribution", [](amplitude * a, double s, double t){ return a->probability_distribution(s, t); }},
+        {"A_LL",                     [](amplitude * a, double s, double t){ return a->A_LL(s, t); }},
+        {"K_LL",                     [](amplitude * a, double s, double t){ return a->K_LL(s, t); }},
+        {"beam_asymmetry_y",         [](amplitude * a, double s, double t){ return a->beam_asymmetry_y(s, t); }},
+        {"beam_asymmetry_4pi",       [](amplitude * a, double s, double t){ return a->beam_asymmetry_4pi(s, t); }},
+        {"parity_asymmetry",         [](amplitude * a, double s, double t){ return a->parity_asymmetry(s, t); }}
+    };
+
+    // Variables a scan may run over
+    static const std::vector<std::string> CONFIG_ENERGIES = {"W", "s", "Egam"};
+    static const std::vector<std::string> CONFIG_ANGLES   = {"theta", "cos", "t"};
+
+    inline bool is_energy(std::string x)
+    {
+        return std::find(CONFIG_ENERGIES.begin(), CONFIG_ENERGIES.end(), x) != CONFIG_ENERGIES.end();
+    };
+
+    inline std::vector<std::string> split(std::string list, char delimiter)
+    {
+        std::vector<std::string> result;
+        std::istringstream iss(list);
+        std::string item;
+        while (std::getline(iss, item, delimiter)) result.push_back(item);
+        return result;
+    };
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::scan_config::scan_config(std::string filename)
+: _filename(filename)
+{
+    std::ifstream in(filename);
+    if (!in.is_open())
+    {
+        std::cout << "scan_config: Cannot open file " << filename << "!\n";
+        return;
+    }
+
+    // Lines ending in \ continue on the next one
+    auto continued = [](std::string & line)
+    {
+        size_t end = line.find_last_not_of(" \t\r");
+        if (end == std::string::npos || line[end] != '\\') return false;
+        line.erase(end);
+        return true;
+    };
+
+    std::string line, next;
+    for (int n = 1, first = 1; std::getline(in, line); first = ++n)
+    {
+        while (continued(line) && std::getline(in, next))
+        {
+            line += " " + next;
+            n++;
+        }
+
+        // Split into words, keeping quoted text together and dropping comments
+        std::vector<std::string> words;
+        std::map<std::string, std::string> options;
+
+        std::string word;
+        bool quoted = false, started = false;
+        int equals = -1;
+        auto finish = [&]()
+        {
+            if (!started) return;
+            if (equals > 0) options[word.substr(0, equals)] = word.substr(equals + 1);
+            else            words.push_back(word);
+            word.clear(); started = false; equals = -1;
+        };
+
+        for (int i = 0; i < line.size(); i++)
+        {
+            char c = line[i];
+            if (!quoted && !started && c == '#') break;
+            if (!quoted && isspace(c)) { finish(); continue; };
+
+            started = true;
+            if (c == '"') { quoted = !quoted; continue; };
+            if (!quoted && c == '=' && equals < 0) equals = word.size();
+            word += c;
+        }
+        finish();
+
+        if (words.empty() && options.empty()) continue;
+
+        _error.clear();
+        if (!read_line(words, options))
+        {
+            std::cout << "scan_config: " << filename << ":" << first << ": " << _error << "\n";
+            return;
+        }
+    }
+
+    _valid = true;
+};
+
+jpacPhoto::scan_config::~scan_config()
+{
+    for (auto it = _amplitudes.begin(); it != _amplitudes.end(); ++it) delete it->second;
+    for (auto it = _trajectories.begin(); it != _trajectories.end(); ++it) delete it->second;
+    for (auto it = _kinematics.begin(); it != _kinematics.end(); ++it) delete it->second;
+    for (int i = 0; i < _checkpoints.size(); i++) delete _checkpoints[i];
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::amplitude * jpacPhoto::scan_config::get_amplitude(std::string name)
+{
+    auto found = _amplitudes.find(name);
+    return (found == _amplitudes.end()) ? NULL : found->second;
+};
+
+// ---------------------------------------------------------------------------
+// Products and quotients of numbers and names
+double jpacPhoto::scan_config::number(std::string expression)
+{
+    if (expression.empty())
+    {
+        if (_error.empty()) _error = "Missing number!";
+        return 0.;
+    }
+
+    double result = 1.;
+    char op = '*';
+    int start = 0;
+    for (int i = 0; i <= expression.size(); i++)
+    {
+        if (i < expression.size() && expression[i] != '*' && expression[i] != '/') continue;
+
+        std::string term = expression.substr(start, i - start);
+        double sign = 1.;
+        if (!term.empty() && (term[0] == '-' || term[0] == '+') && !isdigit(term[1]) && term[1] != '.')
+        {
+            if (term[0] == '-') sign = -1.;
+            term = term.substr(1);
+        }
+
+        double x = 0.;
+        char * end;
+        const char * c = term.c_str();
+        double parsed = strtod(c, &end);
+        if (!term.empty() && *end == '\0') x = parsed;
+        else if (_definitions.count(term)) x = _definitions[term];
+        else if (CONFIG_CONSTANTS.count(term)) x = CONFIG_CONSTANTS.at(term);
+        else
+        {
+            if (_error.empty()) _error = "Unknown number " + term + "!";
+            return 0.;
+        }
+
+        result = (op == '*') ? result * sign * x : result / (sign * x);
+        if (i < expression.size()) op = expression[i];
+        start = i + 1;
+    }
+
+    return result;
+};
+
+std::vector<double> jpacPhoto::scan_config::numbers(std::string list)
+{
+    std::vector<double> result;
+    std::vector<std::string> items = split(list, ',');
+    for (int i = 0; i < items.size(); i++) result.push_back(number(items[i]));
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::scan_config::read_line(std::vector<std::string> words, std::map<std::string, std::string> options)
+{
+    // Options are removed as they are used so any left over at the end are unknown
+    auto take = [&](std::string key)
+    {
+        auto found = options.find(key);
+        if (found == options.end()) return std::string("");
+        std::string value = found->second;
+        options.erase(found);
+        return value;
+    };
+    auto require = [&](std::string key)
+    {
+        bool has = options.count(key);
+        std::string value = take(key);
+        if (!has && _error.empty()) _error = "Missing option " + key + "=!";
+        return value;
+    };
+
+    if (words.size() < 2)
+    {
+        _error = "Expected a keyword and a name!";
+        return false;
+    }
+    std::string keyword = words[0], name = words[1];
+
+    if (keyword == "define")
+    {
+        if (words.size() != 3) { _error = "Expected define <name> <number>!"; return false; };
+        _definitions[name] = number(words[2]);
+    }
+    else if (keyword == "kinematics")
+    {
+        if (_kinematics.count(name)) { _error = "Kinematics " + name + " defined twice!"; return false; };
+
+        double mX = number(require("mX"));
+        double mR = options.count("mR") ? number(take("mR")) : M_PROTON;
+        double mT = options.count("mT") ? number(take("mT")) : M_PROTON;
+        double mB = options.count("mB") ? number(take("mB")) : 0.;
+        std::vector<double> jp = numbers(require("jp"));
+        if (jp.size() != 2 && _error.empty()) _error = "Expected jp=J,P!";
+
+        bool virtual_photon = options.count("Q2");
+        double Q2 = virtual_photon ? number(take("Q2")) : 0.;
+        if (!_error.empty()) return false;
+
+        reaction_kinematics * kinem = new reaction_kinematics(mX, mR, mT, mB);
+        kinem->set_JP(int(jp[0]), int(jp[1]));
+        if (virtual_photon) kinem->set_Q2(Q2);
+        _kinematics[name] = kinem;
+    }
+    else if (keyword == "trajectory")
+    {
+        if (_trajectories.count(name)) { _error = "Trajectory " + name + " defined twice!"; return false; };
+
+        double signature = number(require("signature"));
+        double intercept = number(require("intercept"));
+        double slope     = number(require("slope"));
+        if (!_error.empty()) return false;
+
+        _trajectories[name] = new linear_trajectory(int(signature), intercept, slope, name);
+    }
+    else if (keyword == "amplitude")
+    {
+        if (_amplitudes.count(name)) { _error = "Amplitude " + name + " defined twice!"; return false; };
+        if (words.size() != 3)       { _error = "Expected amplitude <name> <type>!"; return false; };
+
+        reaction_kinematics * kinem = NULL;
+        if (options.count("kinematics"))
+        {
+            std::string k = take("kinematics");
+            if (!_kinematics.count(k)) { _error = "Unknown kinematics " + k + "!"; return false; };
+            kinem = _kinematics[k];
+        }
+        else if (words[2] != "sum")
+        {
+            _error = "Missing option kinematics=!";
+            return false;
+        }
+
+        std::string label = options.count("label") ? take("label") : name;
+        amplitude * amp = make_amplitude(words[2], kinem, label, options);
+        if (amp == NULL) return false;
+
+        _amplitudes[name] = amp;
+    }
+    else if (keyword == "scan")
+    {
+        scan_spec scan;
+        scan.filename = name;
+        scan.amplitudes = split(require("amplitudes"), ',');
+        scan.observable = require("observable");
+        scan.N = number(require("points"));
+
+        std::string format = take("format");
+        if (format == "binary") scan.format = SCAN_FORMAT::BINARY;
+        else if (format != "" && format != "csv" && _error.empty()) _error = "Unknown format " + format + "!";
+
+        // The scanned variable is given a range and the fixed one a single value
+        std::vector<std::string> variables = CONFIG_ENERGIES;
+        variables.insert(variables.end(), CONFIG_ANGLES.begin(), CONFIG_ANGLES.end());
+        for (int i = 0; i < variables.size(); i++)
+        {
+            if (!options.count(variables[i])) continue;
+
+            std::vector<double> range = numbers(take(variables[i]));
+            if (range.size() == 2 && scan.variable.empty())
+            {
+                scan.variable = variables[i];
+                scan.min = range[0]; scan.max = range[1];
+            }
+            else if (range.size() == 1 && scan.fixed.empty())
+            {
+                scan.fixed = variables[i];
+                scan.value = range[0];
+            }
+            else if (_error.empty()) _error = "Expected one variable with a range min,max and at most one fixed value!";
+        }
+
+        scan.plot   = take("plot");
+        scan.xlabel = take("xlabel");
+        scan.ylabel = take("ylabel");
+        scan.logy   = options.count("logy") && number(take("logy")) != 0.;
+
+        if (!_error.empty() || !check_scan(scan)) return false;
+        _scans.push_back(scan);
+    }
+    else
+    {
+        _error = "Unknown keyword " + keyword + "!";
+        return false;
+    }
+
+    if (_error.empty() && !options.empty()) _error = "Unknown option " + options.begin()->first + "= for " + keyword + "!";
+    return _error.empty();
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::amplitude * jpacPhoto::scan_config::make_amplitude(std::string type, reaction_kinematics * kinem, std::string label,
+                                                              std::map<std::string, std::string> & options)
+{
+    auto take = [&](std::string key)
+    {
+        auto found = options.find(key);
+        if (found == options.end()) return std::string("");
+        std::string value = found->second;
+        options.erase(found);
+        return value;
+    };
+    auto require = [&](std::string key)
+    {
+        bool has = options.count(key);
+        std::string value = take(key);
+        if (!has && _error.empty()) _error = "Missing option " + key + "=!";
+        return value;
+    };
+    auto trajectory = [&]()
+    {
+        std::string name = require("trajectory");
+        if (_trajectories.count(name)) return _trajectories[name];
+        if (_error.empty()) _error = "Unknown trajectory " + name + "!";
+        return (linear_trajectory *) NULL;
+    };
+
+    std::vector<double> formfactor;
+    if (options.count("formfactor"))
+    {
+        formfactor = numbers(take("formfactor"));
+        if (formfactor.size() != 2 && _error.empty()) _error = "Expected formfactor=FF,cutoff!";
+    }
+    std::vector<double> params = options.count("params") ? numbers(take("params")) : std::vector<double>();
+
+    amplitude * amp = NULL;
+    if (type == "vector_exchange")
+    {
+        if (options.count("trajectory"))
+        {
+            linear_trajectory * traj = trajectory();
+            if (traj != NULL) amp = new vector_exchange(kinem, traj, label);
+        }
+        else
+        {
+            double mass = number(require("mass"));
+            if (_error.empty()) amp = new vector_exchange(kinem, mass, label);
+        }
+        if (amp != NULL && !formfactor.empty()) static_cast<vector_exchange*>(amp)->set_formfactor(int(formfactor[0]), formfactor[1]);
+    }
+    else if (type == "pseudoscalar_exchange")
+    {
+        if (options.count("trajectory"))
+        {
+            linear_trajectory * traj = trajectory();
+            if (traj != NULL) amp = new pseudoscalar_exchange(kinem, traj, label);
+        }
+        else
+        {
+            double mass = number(require("mass"));
+            if (_error.empty()) amp = new pseudoscalar_exchange(kinem, mass, label);
+        }
+        if (amp != NULL && !formfactor.empty()) static_cast<pseudoscalar_exchange*>(amp)->set_formfactor(int(formfactor[0]), formfactor[1]);
+    }
+    else if (type == "dirac_exchange" || type == "rarita_exchange")
+    {
+        double mass = number(require("mass"));
+        if (_error.empty())
+        {
+            amp = (type == "dirac_exchange") ? new dirac_exchange(kinem, mass, label) : new rarita_exchange(kinem, mass, label);
+            if (!formfactor.empty()) static_cast<dirac_exchange*>(amp)->set_formfactor(int(formfactor[0]), formfactor[1]);
+        }
+    }
+    else if (type == "pomeron_exchange")
+    {
+        linear_trajectory * traj = trajectory();
+        int model = options.count("model") ? int(number(take("model"))) : 0;
+        if (_error.empty()) amp = new pomeron_exchange(kinem, traj, model, label);
+    }
+    else if (type == "baryon_resonance")
+    {
+        // Spin given as J (e.g. 5/2) but the amplitude takes 2J
+        double J     = number(require("J"));
+        double P     = number(require("P"));
+        double mass  = number(require("mass"));
+        double width = number(require("width"));
+        if (_error.empty()) amp = new baryon_resonance(kinem, int(2. * J + 0.5), int(P), mass, width, label);
+    }
+    else if (type == "primakoff_effect")
+    {
+        primakoff_effect * primakoff = new primakoff_effect(kinem, label);
+        if (options.count("LT")) primakoff->set_LT(int(number(take("LT"))));
+        if (options.count("checkpoint"))
+        {
+            _checkpoints.push_back(new checkpoint(take("checkpoint")));
+            primakoff->set_checkpoint(_checkpoints.back());
+        }
+        amp = primakoff;
+    }
+    else if (type == "sum")
+    {
+        std::vector<amplitude*> amps;
+        std::vector<std::string> names = split(require("of"), ',');
+        for (int i = 0; i < names.size() && _error.empty(); i++)
+        {
+            if (_amplitudes.count(names[i])) amps.push_back(_amplitudes[names[i]]);
+            else _error = "Unknown amplitude " + names[i] + "!";
+        }
+        if (_error.empty() && amps.empty()) _error = "Empty sum!";
+
+        if (_error.empty()) amp = new amplitude_sum((kinem != NULL) ? kinem : amps[0]->_kinematics, amps, label);
+    }
+    else
+    {
+        _error = "Unknown amplitude type " + type + "!";
+        return NULL;
+    }
+
+    if (amp == NULL || !_error.empty())
+    {
+        delete amp;
+        return NULL;
+    }
+
+    // Sums only need parameters to change those of their constituents
+    if (type != "sum" || !params.empty())
+    {
+        if (params.size() != amp->_nParams)
+        {
+            _error = "Expected " + std::to_string(amp->_nParams) + " params for " + type + " but found " + std::to_string(params.size()) + "!";
+            delete amp;
+            return NULL;
+        }
+        amp->set_params(params);
+    }
+
+    return amp;
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::scan_config::check_scan(scan_spec & scan)
+{
+    for (int i = 0; i < scan.amplitudes.size(); i++)
+    {
+        if (!_amplitudes.count(scan.amplitudes[i])) { _error = "Unknown amplitude " + scan.amplitudes[i] + "!"; return false; };
+    }
+
+    if (!CONFIG_OBSERVABLES.count(scan.observable))
+    {
+        _error = "Unknown observable " + scan.observable + "!";
+        return false;
+    }
+
+    if (scan.variable.empty())
+    {
+        _error = "Missing the variable to scan over (e.g. W=min,max)!";
+        return false;
+    }
+
+    if (scan.N < 1)
+    {
+        _error = "Scans need at least one point!";
+        return false;
+    }
+
+    // Integrated cross-sections only depend on the energy, everything else also on the angle
+    bool energy = is_energy(scan.variable);
+    if (scan.observable == "integrated_xsection")
+    {
+        if (!energy || !scan.fixed.empty()) _error = "integrated_xsection is only a function of the energy!";
+    }
+    else if (scan.fixed.empty() || is_energy(scan.fixed) == energy)
+    {
+        _error = "Scans of " + scan.observable + " need one energy and one angle variable!";
+    }
+
+    return _error.empty();
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::scan_config::kinematics(scan_spec & scan, amplitude * amp, double x, double & s, double & t)
+{
+    reaction_kinematics * kinem = amp->_kinematics;
+
+    bool energy = is_energy(scan.variable);
+    std::string e_var = energy ? scan.variable : scan.fixed;
+    double e          = energy ? x : scan.value;
+
+    if      (e_var == "W")    s = e * e;
+    else if (e_var == "s")    s = e;
+    else                      s = kinem->s_from_Egam(e);
+
+    t = 0.;
+    if (!(s > kinem->sth())) return false;
+    if (scan.observable == "integrated_xsection") return true;
+
+    std::string a_var = energy ? scan.fixed : scan.variable;
+    double a          = energy ? scan.value : x;
+
+    if (a_var == "theta")
+    {
+        if (a < 0. || a > 180.) return false;
+        t = kinem->t_man(s, a * DEG2RAD);
+    }
+    else if (a_var == "cos")
+    {
+        if (std::abs(a) > 1.) return false;
+        t = kinem->t_man(s, acos(a));
+    }
+    else
+    {
+        t = a;
+        if (t > kinem->t_man(s, 0.) || t < kinem->t_man(s, PI)) return false;
+    }
+
+    return true;
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::scan_config::run(int nThreads, scan_shard shard)
+{
+    if (!_valid) return false;
+
+    bool success = true;
+    for (int n = 0; n < _scans.size(); n++)
+    {
+        scan_spec & scan = _scans[n];
+        std::cout << "scan_config: " << scan.observable << " of " << scan.amplitudes.size() << " amplitudes at "
+                  << scan.N << " points to " << scan.filename << "\n";
+
+        // Copies of every amplitude for each thread
+        std::vector<amplitude_clones*> clones;
+        int threads = std::max(1, nThreads);
+        for (int a = 0; a < scan.amplitudes.size(); a++)
+        {
+            clones.push_back(new amplitude_clones(_amplitudes[scan.amplitudes[a]], threads));
+            threads = std::min(threads, clones.back()->size());
+        }
+
+        observable F = CONFIG_OBSERVABLES.at(scan.observable);
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        auto task = [&](long i, int thread)
+        {
+            double x = (scan.N == 1) ? scan.min : scan.min + double(i) * (scan.max - scan.min) / double(scan.N - 1);
+
+            std::vector<double> values = {x};
+            for (int a = 0; a < clones.size(); a++)
+            {
+                amplitude * amp = (*clones[a])[thread];
+                double s, t;
+                values.push_back(kinematics(scan, amp, x, s, t) ? F(amp, s, t) : nan);
+            }
+            return values;
+        };
+
+        std::vector<std::string> columns = {scan.variable};
+        columns.insert(columns.end(), scan.amplitudes.begin(), scan.amplitudes.end());
+
+        if (shard.N > 1)
+        {
+            sharded_scan(scan.filename, columns, scan.N, shard, threads, task, scan.format);
+        }
+        else
+        {
+            scan_writer out(scan.filename, columns, scan.format);
+            stream_scan(out, scan.N, threads, task);
+
+            if (out.N_written() == scan.N) write_plot(scan);
+            else success = false;
+        }
+
+        for (int a = 0; a < clones.size(); a++) delete clones[a];
+    }
+
+    return success;
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::scan_config::merge(int nShards)
+{
+    if (!_valid) return false;
+
+    bool success = true;
+    for (int n = 0; n < _scans.size(); n++)
+    {
+        if (merge_shards(_scans[n].filename, _scans[n].N, nShards)) write_plot(_scans[n]);
+        else success = false;
+    }
+
+    return success;
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::scan_config::write_plot(scan_spec & scan)
+{
+    if (scan.plot.empty()) return;
+
+    if (scan.format != SCAN_FORMAT::CSV)
+    {
+        std::cout << "scan_config: Plots are only written for scans with format=csv!\n";
+        return;
+    }
+
+    std::ofstream out(scan.plot);
+    if (!out.is_open())
+    {
+        std::cout << "scan_config: Cannot open file " << scan.plot << "!\n";
+        return;
+    }
+
+    std::string output = scan.plot.substr(0, scan.plot.rfind('.')) + ".pdf";
+
+    out << "# Plot of " << scan.filename << " written from " << _filename << "\n";
+    out << "set datafile separator \",\"\n";
+    out << "set key autotitle columnhead noenhanced\n"; // names like P_c4450 are not subscripts
+    out << "set xlabel \"" << (scan.xlabel.empty() ? scan.variable   : scan.xlabel) << "\"\n";
+    out << "set ylabel \"" << (scan.ylabel.empty() ? scan.observable : scan.ylabel) << "\"\n";
+    if (scan.logy) out << "set logscale y\n";
+    out << "set terminal pdfcairo\n";
+    out << "set output \"" << output << "\"\n";
+    out << "plot for [i=2:" << scan.amplitudes.size() + 1 << "] \"" << scan.filename << "\" using 1:i with lines\n";
+};
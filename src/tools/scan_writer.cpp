@@ -0,0 +1,430 @@
+// Streaming output of long scans in fixed-size chunks which can be resumed after interruption
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/scan_writer.hpp"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <unistd.h>
+
+namespace jpacPhoto
+{
+    static const char SCAN_MAGIC[8] = {'J', 'P', 'A', 'C', 'S', 'C', 'N', '1'};
+
+    // Names of the columns as they appear in the header of either format
+    inline std::string csv_header(std::vector<std::string> columns)
+    {
+        std::string line;
+        for (int k = 0; k < columns.size(); k++) line += (k == 0 ? "" : ",") + columns[k];
+        return line;
+    };
+
+    // Read the header of a binary file, returns false if it is not one
+    inline bool read_scan_header(std::ifstream & in, std::vector<std::string> & columns, int & chunk)
+    {
+        char magic[8];
+        in.read(magic, 8);
+        if (!in.good() || !std::equal(magic, magic + 8, SCAN_MAGIC)) return false;
+
+        int32_t n, c;
+        in.read(reinterpret_cast<char*>(&n), sizeof(n));
+        in.read(reinterpret_cast<char*>(&c), sizeof(c));
+        chunk = c;
+
+        columns.clear();
+        for (int k = 0; k < n && in.good(); k++)
+        {
+            int32_t length;
+            in.read(reinterpret_cast<char*>(&length), sizeof(length));
+            std::string name(length, ' ');
+            in.read(&name[0], length);
+            columns.push_back(name);
+        }
+
+        return in.good();
+    };
+};
+
+// ---------------------------------------------------------------------------
+long jpacPhoto::scan_writer::open(bool resume)
+{
+    if (_out.is_open()) return _written;
+
+    _written = 0;
+    _pending.clear();
+    _buffer.clear();
+
+    long bytes = 0;
+    if (resume && std::ifstream(_filename).good())
+    {
+        long done = (_format == SCAN_FORMAT::BINARY) ? resume_binary(bytes) : resume_csv(bytes);
+        if (done < 0)
+        {
+            std::cout << "scan_writer: Existing file " << _filename << " does not match the columns of this scan!\n";
+            return -1;
+        }
+
+        // Drop anything after the last complete chunk and append
+        if (truncate(_filename.c_str(), bytes) != 0)
+        {
+            std::cout << "scan_writer: Cannot resume file " << _filename << "!\n";
+            return -1;
+        }
+
+        _written = done;
+        _out.open(_filename, std::ios::binary | std::ios::app);
+    }
+    else
+    {
+        _out.open(_filename, std::ios::binary | std::ios::trunc);
+        if (_out.is_open() && _format == SCAN_FORMAT::BINARY)
+        {
+            int32_t n = _columns.size(), c = _chunk;
+            _out.write(SCAN_MAGIC, 8);
+            _out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+            _out.write(reinterpret_cast<const char*>(&c), sizeof(c));
+            for (int k = 0; k < _columns.size(); k++)
+            {
+                int32_t length = _columns[k].size();
+                _out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+                _out.write(_columns[k].data(), length);
+            }
+        }
+        else if (_out.is_open())
+        {
+            _out << csv_header(_columns) << "\n";
+        }
+        _out.flush();
+    }
+
+    if (!_out.is_open())
+    {
+        std::cout << "scan_writer: Cannot open file " << _filename << "!\n";
+        return -1;
+    }
+
+    return _written;
+};
+
+// ---------------------------------------------------------------------------
+long jpacPhoto::scan_writer::resume_binary(long & bytes)
+{
+    std::ifstream in(_filename, std::ios::binary | std::ios::ate);
+    long size = in.tellg();
+    in.seekg(0);
+
+    std::vector<std::string> columns;
+    int chunk;
+    if (!read_scan_header(in, columns, chunk) || columns != _columns) return -1;
+
+    // Chunks are complete if all their values are in the file
+    bytes = in.tellg();
+    long done = 0;
+    while (true)
+    {
+        int64_t first;
+        int32_t nRows, pad;
+        in.read(reinterpret_cast<char*>(&first), sizeof(first));
+        in.read(reinterpret_cast<char*>(&nRows), sizeof(nRows));
+        in.read(reinterpret_cast<char*>(&pad),   sizeof(pad));
+        if (!in.good() || first != done || nRows <= 0) break;
+
+        long length = 16 + long(nRows) * _columns.size() * sizeof(double);
+        if (bytes + length > size) break;
+
+        done  += nRows;
+        bytes += length;
+        in.seekg(bytes);
+    }
+
+    return done;
+};
+
+long jpacPhoto::scan_writer::resume_csv(long & bytes)
+{
+    std::ifstream in(_filename, std::ios::binary);
+
+    std::string line;
+    if (!std::getline(in, line) || in.eof() || line != csv_header(_columns)) return -1;
+
+    bytes = in.tellg();
+    long done = 0;
+    while (std::getline(in, line))
+    {
+        // A last line without newline is incomplete
+        if (in.eof()) break;
+
+        done++;
+        bytes = in.tellg();
+    }
+
+    return done;
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::scan_writer::add(long i, std::vector<double> values)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    long next = _written + _buffer.size();
+    if (i < next) return;
+
+    _pending[i] = values;
+
+    for (auto it = _pending.begin(); it != _pending.end() && it->first == next; it = _pending.erase(it), next++)
+    {
+        _buffer.push_back(it->second);
+        if (_buffer.size() == _chunk) write_buffer();
+    }
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::scan_writer::write_buffer()
+{
+    if (_buffer.empty() || !_out.is_open()) return;
+
+    int nRows = _buffer.size();
+    if (_format == SCAN_FORMAT::BINARY)
+    {
+        int64_t first = _written;
+        int32_t n = nRows, pad = 0;
+        _out.write(reinterpret_cast<const char*>(&first), sizeof(first));
+        _out.write(reinterpret_cast<const char*>(&n),     sizeof(n));
+        _out.write(reinterpret_cast<const char*>(&pad),   sizeof(pad));
+
+        std::vector<double> column(nRows);
+        for (int k = 0; k < _columns.size(); k++)
+        {
+            for (int i = 0; i < nRows; i++) column[i] = (k < _buffer[i].size()) ? _buffer[i][k] : 0.;
+            _out.write(reinterpret_cast<const char*>(column.data()), nRows * sizeof(double));
+        }
+    }
+    else
+    {
+        std::ostringstream lines;
+        lines << std::setprecision(17);
+        for (int i = 0; i < nRows; i++)
+        {
+            for (int k = 0; k < _columns.size(); k++)
+            {
+                lines << (k == 0 ? "" : ",") << ((k < _buffer[i].size()) ? _buffer[i][k] : 0.);
+            }
+            lines << "\n";
+        }
+        _out << lines.str();
+    }
+
+    _out.flush();
+    _written += nRows;
+    _buffer.clear();
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::scan_writer::close()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_out.is_open()) return;
+
+    write_buffer();
+    if (!_pending.empty())
+    {
+        std::cout << "scan_writer: " << _pending.size() << " points after a missing point " << _written << " were not written to " << _filename << "!\n";
+        _pending.clear();
+    }
+
+    _out.close();
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::stream_scan(scan_writer & out, long N, int nThreads, std::function<std::vector<double>(long, int)> task)
+{
+    long done = out.open();
+    if (done < 0) return;
+
+    // parallel_for() counts tasks with an int so longer scans are run in blocks
+    const long block = std::numeric_limits<int>::max();
+    for (long first = done; first < N; first += block)
+    {
+        parallel_for(int(std::min(N - first, block)), nThreads, [&](int i, int thread)
+        {
+            out.add(first + i, task(first + i, thread));
+        });
+    }
+
+    out.close();
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::scan_data jpacPhoto::read_scan(std::string filename)
+{
+    scan_data result;
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open())
+    {
+        std::cout << "read_scan: Cannot open file " << filename << "!\n";
+        return result;
+    }
+
+    int chunk;
+    if (read_scan_header(in, result.names, chunk))
+    {
+        result.columns.resize(result.names.size());
+        while (true)
+        {
+            int64_t first;
+            int32_t nRows, pad;
+            in.read(reinterpret_cast<char*>(&first), sizeof(first));
+            in.read(reinterpret_cast<char*>(&nRows), sizeof(nRows));
+            in.read(reinterpret_cast<char*>(&pad),   sizeof(pad));
+            if (!in.good() || nRows <= 0) break;
+
+            std::vector<std::vector<double>> values(result.names.size(), std::vector<double>(nRows));
+            for (int k = 0; k < values.size(); k++) in.read(reinterpret_cast<char*>(values[k].data()), nRows * sizeof(double));
+            if (!in.good()) break;
+
+            for (int k = 0; k < values.size(); k++)
+            {
+                result.columns[k].insert(result.columns[k].end(), values[k].begin(), values[k].end());
+            }
+        }
+
+        return result;
+    }
+
+    // Otherwise CSV
+    result.format = SCAN_FORMAT::CSV;
+    in.clear();
+    in.seekg(0);
+
+    std::string line;
+    if (!std::getline(in, line)) return result;
+
+    std::istringstream names(line);
+    std::string name;
+    while (std::getline(names, name, ',')) result.names.push_back(name);
+    result.columns.resize(result.names.size());
+
+    while (std::getline(in, line))
+    {
+        if (in.eof()) break;
+
+        std::vector<double> values;
+        std::istringstream iss(line);
+        std::string x;
+        while (std::getline(iss, x, ',')) values.push_back(std::stod(x));
+        if (values.size() != result.names.size()) break;
+
+        for (int k = 0; k < values.size(); k++) result.columns[k].push_back(values[k]);
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::scan_shard jpacPhoto::parse_shard(std::string shard)
+{
+    int index, N;
+    char slash, rest;
+    std::istringstream iss(shard);
+    if (!(iss >> index >> slash >> N) || slash != '/' || (iss >> rest) || !scan_shard(index, N).valid())
+    {
+        std::cout << "parse_shard: Invalid shard " << shard << " (expected index/N with 0 <= index < N)! Using the full scan.\n";
+        return scan_shard();
+    }
+
+    return scan_shard(index, N);
+};
+
+// ---------------------------------------------------------------------------
+std::string jpacPhoto::shard_filename(std::string filename, scan_shard shard)
+{
+    return filename + "." + std::to_string(shard.index) + "-of-" + std::to_string(shard.N);
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::sharded_scan(std::string filename, std::vector<std::string> columns, long N, scan_shard shard, int nThreads,
+                             std::function<std::vector<double>(long, int)> task,
+                             SCAN_FORMAT format, int chunk)
+{
+    if (!shard.valid())
+    {
+        std::cout << "sharded_scan: Invalid shard " << shard.index << " of " << shard.N << "!\n";
+        return;
+    }
+
+    long first = shard.first(N);
+    scan_writer out(shard_filename(filename, shard), columns, format, chunk);
+    stream_scan(out, shard.last(N) - first, nThreads, [&](long i, int thread)
+    {
+        return task(first + i, thread);
+    });
+};
+
+// ---------------------------------------------------------------------------
+bool jpacPhoto::merge_shards(std::string filename, long N, int nShards, int chunk)
+{
+    if (nShards < 1)
+    {
+        std::cout << "merge_shards: Invalid number of shards " << nShards << "!\n";
+        return false;
+    }
+
+    // Read and check everything first so a failed merge leaves no partial file
+    std::vector<scan_data> shards(nShards);
+    bool valid = true;
+    for (int k = 0; k < nShards; k++)
+    {
+        scan_shard shard(k, nShards);
+        std::string name = shard_filename(filename, shard);
+
+        if (!std::ifstream(name).good())
+        {
+            std::cout << "merge_shards: Shard " << name << " is missing!\n";
+            valid = false;
+            continue;
+        }
+
+        shards[k] = read_scan(name);
+        long expected = shard.last(N) - shard.first(N);
+        long found    = shards[k].columns.empty() ? 0 : shards[k].columns[0].size();
+
+        if (shards[k].names != shards[0].names || shards[k].format != shards[0].format)
+        {
+            std::cout << "merge_shards: Shard " << name << " does not have the same columns and format as the first shard!\n";
+            valid = false;
+        }
+        else if (found != expected)
+        {
+            std::cout << "merge_shards: Shard " << name << " has " << found << " of " << expected << " points!\n";
+            valid = false;
+        }
+    }
+    if (!valid) return false;
+
+    scan_writer out(filename, shards[0].names, shards[0].format, chunk);
+    if (out.open(false) < 0) return false;
+
+    long i = 0;
+    for (int k = 0; k < nShards; k++)
+    {
+        long n = shards[k].columns.empty() ? 0 : shards[k].columns[0].size();
+        for (long j = 0; j < n; j++, i++)
+        {
+            std::vector<double> values(shards[k].names.size());
+            for (int c = 0; c < values.size(); c++) values[c] = shards[k].columns[c][j];
+            out.add(i, values);
+        }
+    }
+    out.close();
+
+    return (out.N_written() == N);
+};
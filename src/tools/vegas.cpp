@@ -0,0 +1,210 @@
+// VEGAS adaptive importance sampling for multi-dimensional integrals
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "tools/vegas.hpp"
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::vegas_integrator::reset_grid()
+{
+    _edges.assign(_dim, std::vector<double>(_nBins + 1));
+    for (int k = 0; k < _dim; k++)
+    {
+        for (int i = 0; i <= _nBins; i++) _edges[k][i] = double(i) / double(_nBins);
+    }
+
+    _trained = false;
+};
+
+// ---------------------------------------------------------------------------
+std::array<double, 2> jpacPhoto::vegas_integrator::iteration(batch_integrand & F, std::vector<double> & lower, std::vector<double> & upper, 
+                                                             int k, std::vector<std::vector<double>> & d)
+{
+    int nBatches = (_nCalls + _batch - 1) / _batch;
+
+    // Partial sums of each batch, added in order after
+    std::vector<std::array<double, 2>> sums(nBatches, {0., 0.});
+    std::vector<std::vector<double>> bin_sums(nBatches);
+
+    parallel_for(nBatches, _nThreads, [&](int b, int thread)
+    {
+        std::seed_seq seq{(unsigned long) _seed, (unsigned long) k, (unsigned long) b};
+        std::mt19937_64 gen(seq);
+        std::uniform_real_distribution<double> uniform(0., 1.);
+
+        int n = std::min(_batch, _nCalls - b * _batch);
+        std::vector<double> x(n * _dim), f(n), jacobian(n, 1.);
+        std::vector<int> bins(n * _dim);
+
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = 0; j < _dim; j++)
+            {
+                double y = uniform(gen) * double(_nBins);
+                int bin  = std::min(int(y), _nBins - 1);
+
+                double width = _edges[j][bin + 1] - _edges[j][bin];
+                double u     = _edges[j][bin] + (y - double(bin)) * width;
+
+                x[i*_dim + j]    = lower[j] + (upper[j] - lower[j]) * u;
+                bins[i*_dim + j] = bin;
+                jacobian[i]     *= double(_nBins) * width * (upper[j] - lower[j]);
+            }
+        }
+
+        F(n, x.data(), f.data(), thread);
+
+        bin_sums[b].assign(_dim * _nBins, 0.);
+        for (int i = 0; i < n; i++)
+        {
+            double fj = f[i] * jacobian[i];
+            sums[b][0] += fj;
+            sums[b][1] += fj * fj;
+
+            for (int j = 0; j < _dim; j++) bin_sums[b][j*_nBins + bins[i*_dim + j]] += fj * fj;
+        }
+    });
+
+    double sum = 0., sum2 = 0.;
+    d.assign(_dim, std::vector<double>(_nBins, 0.));
+    for (int b = 0; b < nBatches; b++)
+    {
+        sum  += sums[b][0];
+        sum2 += sums[b][1];
+        for (int j = 0; j < _dim; j++)
+        {
+            for (int i = 0; i < _nBins; i++) d[j][i] += bin_sums[b][j*_nBins + i];
+        }
+    }
+
+    double N = double(_nCalls);
+    double mean = sum / N;
+    double variance = std::max(sum2 / N - mean * mean, 0.) / (N - 1.);
+
+    return {mean, variance};
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::vegas_integrator::adapt(std::vector<std::vector<double>> & d)
+{
+    for (int j = 0; j < _dim; j++)
+    {
+        // Smooth the contributions of neighboring bins
+        std::vector<double> smooth(_nBins);
+        for (int i = 0; i < _nBins; i++)
+        {
+            double lo = d[j][std::max(i - 1, 0)], hi = d[j][std::min(i + 1, _nBins - 1)];
+            smooth[i] = (lo + d[j][i] + hi) / 3.;
+        }
+
+        double total = 0.;
+        for (int i = 0; i < _nBins; i++) total += smooth[i];
+        if (total <= 0.) continue;
+
+        // Damped importance of each bin
+        std::vector<double> r(_nBins, 0.);
+        double R = 0.;
+        for (int i = 0; i < _nBins; i++)
+        {
+            double x = smooth[i] / total;
+            if (x > 0. && x < 1.) r[i] = pow((1. - x) / log(1. / x), _alpha);
+            else if (x >= 1.)     r[i] = 1.;
+            R += r[i];
+        }
+        if (R <= 0.) continue;
+
+        // New edges with equal importance between them
+        std::vector<double> edges(_nBins + 1);
+        edges[0] = 0.; edges[_nBins] = 1.;
+
+        double delta = R / double(_nBins), accumulated = 0.;
+        int bin = 0;
+        for (int i = 1; i < _nBins; i++)
+        {
+            double target = double(i) * delta;
+            while (bin < _nBins - 1 && accumulated + r[bin] < target)
+            {
+                accumulated += r[bin];
+                bin++;
+            }
+
+            double fraction = (r[bin] > 0.) ? (target - accumulated) / r[bin] : 0.;
+            fraction = std::min(std::max(fraction, 0.), 1.);
+            edges[i] = _edges[j][bin] + fraction * (_edges[j][bin + 1] - _edges[j][bin]);
+        }
+
+        _edges[j] = edges;
+    }
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::vegas_result jpacPhoto::vegas_integrator::integrate(batch_integrand F, std::vector<double> lower, std::vector<double> upper)
+{
+    if (lower.size() != _dim || upper.size() != _dim)
+    {
+        std::cout << "vegas_integrator: Bounds do not match the dimension (" << _dim << ")! Returning 0!\n";
+        return {0., 0., 0.};
+    }
+
+    std::vector<std::vector<double>> d;
+
+    // Learn the grid
+    if (!_trained)
+    {
+        for (int k = 0; k < _nAdapt; k++)
+        {
+            iteration(F, lower, upper, k, d);
+            adapt(d);
+        }
+        _trained = true;
+    }
+
+    // Combine the final iterations weighted by their variance
+    // (streams numbered after the adapting iterations so every call uses the same points)
+    std::vector<std::array<double, 2>> estimates;
+    for (int i = 0; i < _nFinal; i++)
+    {
+        estimates.push_back(iteration(F, lower, upper, _nAdapt + i, d));
+    }
+
+    double weights = 0., sum = 0.;
+    bool exact = false;
+    for (int i = 0; i < estimates.size(); i++)
+    {
+        // A vanishing variance means the integrand is constant under the grid
+        if (estimates[i][1] <= 0.) { exact = true; sum = estimates[i][0]; break; }
+
+        weights += 1. / estimates[i][1];
+        sum     += estimates[i][0] / estimates[i][1];
+    }
+
+    vegas_result result = {sum, 0., 0.};
+    if (exact) return result;
+
+    result.value = sum / weights;
+    result.error = sqrt(1. / weights);
+
+    if (estimates.size() > 1)
+    {
+        double chi2 = 0.;
+        for (int i = 0; i < estimates.size(); i++) chi2 += pow(estimates[i][0] - result.value, 2.) / estimates[i][1];
+        result.chi2_dof = chi2 / double(estimates.size() - 1);
+    }
+
+    return result;
+};
+
+// ---------------------------------------------------------------------------
+jpacPhoto::vegas_result jpacPhoto::vegas_integrator::integrate(std::function<double(const double *, int)> f, std::vector<double> lower, std::vector<double> upper)
+{
+    int dim = _dim;
+    batch_integrand F = [&](int n, const double * x, double * y, int thread)
+    {
+        for (int i = 0; i < n; i++) y[i] = f(x + i*dim, thread);
+    };
+
+    return integrate(F, lower, upper);
+};
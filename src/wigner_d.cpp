@@ -6,6 +6,24 @@
 // ---------------------------------------------------------------------------
 
 #include "misc_math.hpp"
+#include <limits>
+#include <vector>
+
+// --------------------------------------------------------------------------
+double jpacPhoto::factorial_table(int n)
+{
+    static const std::vector<double> table = []()
+    {
+        std::vector<double> t(171, 1.);
+        for (int i = 1; i <= 170; i++) t[i] = t[i-1] * double(i);
+        return t;
+    }();
+
+    // Beyond 170! the factorial overflows a double
+    if (n > 170) return std::numeric_limits<double>::infinity();
+    if (n < 0)   return 0.;
+    return table[n];
+};
 
 // --------------------------------------------------------------------------
 double jpacPhoto::wigner_leading_coeff(int j, int lam1, int lam2)
@@ -15,11 +33,11 @@ double jpacPhoto::wigner_leading_coeff(int j, int lam1, int lam2)
 
     int lambda = std::abs(lam1 - lam2) + lam1 - lam2;
 
-    double result = (double) factorial(2*j);
-    result /= sqrt( (double) factorial(j-M));
-    result /= sqrt( (double) factorial(j+M));
-    result /= sqrt( (double) factorial(j-N));
-    result /= sqrt( (double) factorial(j+N));
+    double result = factorial_table(2*j);
+    result /= sqrt(factorial_table(j-M));
+    result /= sqrt(factorial_table(j+M));
+    result /= sqrt(factorial_table(j-N));
+    result /= sqrt(factorial_table(j+N));
     result /= pow(2.,  double(j-M));
     result *= pow(-1., double(lambda)/2.);
 
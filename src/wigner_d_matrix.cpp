@@ -0,0 +1,76 @@
+// Wigner little-d matrix for arbitrary spin
+//
+// Author:       Daniel Winney (2020)
+// Affiliation:  Joint Physics Analysis Center (JPAC)
+// Email:        dwinney@iu.edu
+// ---------------------------------------------------------------------------
+
+#include "wigner_d_matrix.hpp"
+
+// ---------------------------------------------------------------------------
+jpacPhoto::wigner_d_matrix::wigner_d_matrix(int two_j)
+: _j(two_j), _d((two_j + 2) * (two_j + 2), 0.), _last((two_j + 2) * (two_j + 2), 0.)
+{
+    for (int k = 0; k <= _j; k++) _roots.push_back(sqrt(double(k)));
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::wigner_d_matrix::update(double theta)
+{
+    if (_saved && !_useCos && real(_arg) == theta) return;
+    _saved = true; _useCos = false; _arg = theta;
+
+    evaluate(cos(theta / 2.), sin(theta / 2.));
+};
+
+// ---------------------------------------------------------------------------
+void jpacPhoto::wigner_d_matrix::update_cos(std::complex<double> cosine)
+{
+    if (_saved && _useCos && _arg == cosine) return;
+    _saved = true; _useCos = true; _arg = cosine;
+
+    evaluate(sqrt((XR + cosine) / 2.), sqrt((XR - cosine) / 2.));
+};
+
+// ---------------------------------------------------------------------------
+// Risbo's recurrence, building spin n/2 from spin (n-1)/2 by coupling one more spin 1/2.
+// With a = j - m' and b = j - m labeling rows and columns, c = cos(theta/2) and s = sin(theta/2):
+//
+//   n d^n_{a,b} = sqrt(n-b) ( c sqrt(n-a) d^{n-1}_{a,b}   + s sqrt(a) d^{n-1}_{a-1,b}   )
+//               + sqrt(b)   (-s sqrt(n-a) d^{n-1}_{a,b-1} + c sqrt(a) d^{n-1}_{a-1,b-1} )
+//
+// All weights are at most one so rounding errors do not grow with the spin,
+// unlike the cancellations in the explicit sum over factorials.
+void jpacPhoto::wigner_d_matrix::evaluate(std::complex<double> coshalf, std::complex<double> sinhalf)
+{
+    // Both matrices have a border of zeros in front of the first row and column (see index())
+    // and zeros beyond the part filled so far, so no bounds need to be checked
+    int stride = _j + 2;
+    std::fill(_d.begin(), _d.end(), 0.);
+    std::fill(_last.begin(), _last.end(), 0.);
+    _d[stride + 1] = 1.;
+
+    for (int n = 1; n <= _j; n++)
+    {
+        std::swap(_d, _last);
+        double inv_n = 1. / double(n);
+
+        for (int a = 0; a <= n; a++)
+        {
+            const std::complex<double> * row  = &_last[(a + 1) * stride + 1];
+            const std::complex<double> * prev = &_last[a * stride + 1];
+            std::complex<double> * out = &_d[(a + 1) * stride + 1];
+
+            std::complex<double> c_a = coshalf * _roots[a], s_a = sinhalf * _roots[a];
+            std::complex<double> c_na = coshalf * _roots[n - a], s_na = sinhalf * _roots[n - a];
+
+            for (int b = 0; b <= n; b++)
+            {
+                std::complex<double> x;
+                x  = _roots[n - b] * (c_na * row[b]     + s_a * prev[b]);
+                x += _roots[b]     * (c_a  * prev[b - 1] - s_na * row[b - 1]);
+                out[b] = x * inv_n;
+            }
+        }
+    }
+};